@@ -0,0 +1,10 @@
+#pragma once
+#include <span>
+#include "metrics.hpp"
+
+// Counting-sort fast path shared by the quicksort and mergesort entry points.
+// Sorts a and returns true when T has an integral key (integers, record keys)
+// and the keys of a span fewer than maxRange values; otherwise returns false
+// and leaves a untouched. maxRange <= 0 disables the probe. Stable.
+template<class T, class M>
+bool counting_sort_small_range(std::span<T> a, int maxRange, M& m);
@@ -7,7 +7,13 @@
 // Forward declare Dist - defined in evaluator.hpp
 enum class Dist;
 
-std::vector<int> make_array(std::size_t n, Dist d, uint64_t seed);
+// Generated input of element type T (int, int64_t, float, double or Record;
+// see ElemTraits in elem.hpp for how values map onto each type).
+template<class T = int>
+std::vector<T> make_array(std::size_t n, Dist d, uint64_t seed);
 
 // Kaggle importer: picks first numeric column; truncates/extends to n by cycling/seeding.
 std::vector<int> load_kaggle_column_as_ints(const std::string& csv_path, std::size_t n);
+// Same column converted to T in order (Record rowids are the row positions)
+template<class T>
+std::vector<T> load_kaggle_column_as(const std::string& csv_path, std::size_t n);
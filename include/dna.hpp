@@ -1,18 +1,136 @@
 #pragma once
+#include <variant>
 
-enum class Pivot { First, Last, Median3 };
-enum class PartitionScheme { Lomuto, Hoare };
+enum class Pivot { First, Last, Median3, Ninther, Median5, Sampled };
+enum class PartitionScheme { Lomuto, Hoare, Block, ThreeWay, Simd };
+enum class DepthFallback { InsertionSort, HeapSort, MergeSort };
+enum class SmallSort { Insertion, Unguarded, Binary, Network };
+enum class MergeBuffer { PerLevel, Arena };
+enum class MergeKernel { Branchy, Branchless, Simd };
+enum class RadixOrder { LSD, MSD };
+enum class SampleBase { QuickSort, MergeSort, Radix };
 
 struct QSDNA {
   Pivot pivot{Pivot::Median3};
   PartitionScheme scheme{PartitionScheme::Hoare};
   int insertionCutoff{16};     // [0..64]
+  SmallSort smallSortKind{SmallSort::Insertion}; // kernel for slices <= insertionCutoff
   int depthCap{64};            // ~ [floor(log2 n) .. floor(2*log2 n)]
   bool tailRecElim{true};
+  int pivotCount{1};           // [1..3] 2 = Yaroslavskiy dual-pivot, 3 = three-pivot
+  DepthFallback depthFallback{DepthFallback::HeapSort}; // used once depthCap runs out
+  bool equalLeft{false};       // pdqsort: pivot == predecessor => skip the equal run
+  bool presortCheck{false};    // pdqsort: partition moved nothing => try bounded insertion sort
+  bool patternShuffle{false};  // pdqsort: very unbalanced split => swap a few elements
+  int threads{1};              // [1..hardware threads] > 1 = task-parallel on a work-stealing pool
+  int parallelGrain{16384};    // [1024..1<<20] smallest slice spawned as a task
+  int countingThreshold{0};    // [0..1<<20] integral keys spanning fewer values are counting-sorted; 0 = off
 };
 
 struct MSDNA {
   int runThreshold{16};        // [0..64]
   bool iterative{true};
-  bool reuseBuffer{true};
+  bool reuseBuffer{true};      // lease scratch from the shared pool instead of allocating per sort
+  MergeBuffer buffer{MergeBuffer::Arena}; // recursive path: one arena per sort vs a vector per merge
+  MergeKernel mergeKernel{MergeKernel::Branchy}; // inner merge loop
+  bool natural{false};         // Powersort over detected runs with galloping; overrides iterative
+  int minRun{32};              // [8..64] natural mode: shorter runs are padded by binary insertion
+  int minGallop{7};            // [1..64] natural mode: consecutive wins before galloping
+  int mergeArity{2};           // {2,4,8,16} bottom-up: runs merged per pass (loser tree above 2)
+  bool inPlace{false};         // rotation merges, no n-sized buffer; overrides every other mode
+  int inPlaceBuffer{256};      // [0..4096] in-place mode: fixed scratch elements for short merges
+  int threads{1};              // [1..hardware threads] > 1 = parallel chunk sorts + merge-path merges
+  int parallelGrain{16384};    // [1024..1<<20] smallest chunk / merge piece handed to a task
+  SmallSort smallSortKind{SmallSort::Insertion}; // kernel for the runThreshold pre-pass; Network runs as Binary (stable)
+  int countingThreshold{0};    // [0..1<<20] integral keys spanning fewer values are counting-sorted; 0 = off
 };
+
+// A DNA with every gene a compile-time constant. The quicksort and mergesort
+// kernels are templated on the DNA type and read genes as dna.x; on these
+// types each read finds the static member below, which hides the base field,
+// so the value folds in and branches on discrete genes drop out. The base
+// holds V too, for the places that copy the DNA.
+template<QSDNA V>
+struct QSFixed : QSDNA {
+  constexpr QSFixed() : QSDNA(V) {}
+  static constexpr Pivot pivot = V.pivot;
+  static constexpr PartitionScheme scheme = V.scheme;
+  static constexpr int insertionCutoff = V.insertionCutoff;
+  static constexpr SmallSort smallSortKind = V.smallSortKind;
+  static constexpr int depthCap = V.depthCap;
+  static constexpr bool tailRecElim = V.tailRecElim;
+  static constexpr int pivotCount = V.pivotCount;
+  static constexpr DepthFallback depthFallback = V.depthFallback;
+  static constexpr bool equalLeft = V.equalLeft;
+  static constexpr bool presortCheck = V.presortCheck;
+  static constexpr bool patternShuffle = V.patternShuffle;
+  static constexpr int threads = V.threads;
+  static constexpr int parallelGrain = V.parallelGrain;
+  static constexpr int countingThreshold = V.countingThreshold;
+};
+
+template<MSDNA V>
+struct MSFixed : MSDNA {
+  constexpr MSFixed() : MSDNA(V) {}
+  static constexpr int runThreshold = V.runThreshold;
+  static constexpr bool iterative = V.iterative;
+  static constexpr bool reuseBuffer = V.reuseBuffer;
+  static constexpr MergeBuffer buffer = V.buffer;
+  static constexpr MergeKernel mergeKernel = V.mergeKernel;
+  static constexpr bool natural = V.natural;
+  static constexpr int minRun = V.minRun;
+  static constexpr int minGallop = V.minGallop;
+  static constexpr int mergeArity = V.mergeArity;
+  static constexpr bool inPlace = V.inPlace;
+  static constexpr int inPlaceBuffer = V.inPlaceBuffer;
+  static constexpr int threads = V.threads;
+  static constexpr int parallelGrain = V.parallelGrain;
+  static constexpr SmallSort smallSortKind = V.smallSortKind;
+  static constexpr int countingThreshold = V.countingThreshold;
+};
+
+// Entries of the runtime kernel tables in quicksort.cpp / mergesort.cpp:
+// pivot, scheme and tailRecElim (MS: iterative, reuseBuffer, mergeKernel) are
+// constants; all other genes, discrete ones included, are read from the base
+// at runtime.
+template<Pivot P, PartitionScheme S, bool Tail>
+struct QSKernel : QSDNA {
+  constexpr explicit QSKernel(const QSDNA& d) : QSDNA(d) {}
+  static constexpr Pivot pivot = P;
+  static constexpr PartitionScheme scheme = S;
+  static constexpr bool tailRecElim = Tail;
+};
+
+template<bool Iterative, bool Reuse, MergeKernel K>
+struct MSKernel : MSDNA {
+  constexpr explicit MSKernel(const MSDNA& d) : MSDNA(d) {}
+  static constexpr bool iterative = Iterative;
+  static constexpr bool reuseBuffer = Reuse;
+  static constexpr MergeKernel mergeKernel = K;
+};
+
+struct RadixDNA {
+  int digitBits{8};            // [4..16] key bits sorted per pass
+  RadixOrder order{RadixOrder::LSD};
+  bool inPlace{false};         // MSD: American-flag permutation instead of a scratch buffer (not stable)
+  int fallbackThreshold{64};   // [0..4096] slices (MSD buckets) at or below this go to quicksort
+  bool prefetch{false};        // prefetch scatter targets a few elements ahead
+};
+
+struct SampleDNA {
+  int buckets{64};             // {4..256} splitter-tree leaves per level (power of two)
+  int oversample{8};           // [1..32] sample elements drawn per bucket
+  SampleBase baseCase{SampleBase::QuickSort}; // sort for slices at or below baseThreshold
+  int baseThreshold{4096};     // [256..65536]
+  int threads{1};              // [1..hardware threads] > 1 = parallel top level + bucket tasks
+  int parallelGrain{16384};    // [1024..1<<20] smallest chunk a thread classifies
+};
+
+struct LearnedDNA {
+  int samplePermille{10};      // [1..100] training sample, in 1/1000 of the input
+  int segments{256};           // {16..4096} linear pieces of the CDF model (power of two)
+  int fanout{1024};            // {16..4096} buckets of the first scatter pass (power of two)
+};
+
+// One DNA of any algorithm family; alternatives in Algo order (logging.hpp).
+using AnyDNA = std::variant<QSDNA, MSDNA, RadixDNA, SampleDNA, LearnedDNA>;
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+// Element types the sorts are built for, selected with --elem=
+enum class Elem { I32, I64, F32, F64, Record };
+
+// 16-byte key/payload record, ordered by key only
+struct Record {
+  uint64_t key;
+  uint64_t rowid;
+  friend bool operator<(const Record& a, const Record& b) { return a.key < b.key; }
+  friend bool operator==(const Record& a, const Record& b) { return a.key == b.key && a.rowid == b.rowid; }
+};
+
+// Per-type hooks for the dataset generators and the sorting networks.
+// from_int maps an ordinal (sorted position, duplicate bucket, Kaggle value)
+// so that order is preserved; from_random spreads raw rng bits over the type.
+template<class T> struct ElemTraits {
+  static constexpr T max() { return std::numeric_limits<T>::max(); }
+  static T from_int(int64_t v, std::size_t) { return T(v); }
+  static T from_random(uint64_t r, std::size_t) {
+    if constexpr (std::is_floating_point_v<T>) return T((r >> 11) * (1.0/9007199254740992.0));
+    else if constexpr (sizeof(T) == 4) return T(r & 0x7fffffff);
+    else return T(r >> 1);
+  }
+};
+template<> struct ElemTraits<Record> {
+  static constexpr Record max() { return {std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max()}; }
+  static Record from_int(int64_t v, std::size_t i) { return {uint64_t(v) ^ (uint64_t(1) << 63), i}; }
+  static Record from_random(uint64_t r, std::size_t i) { return {r, i}; }
+};
+
+inline const char* elem_name(Elem e) {
+  switch (e) {
+    case Elem::I64: return "i64"; case Elem::F32: return "f32";
+    case Elem::F64: return "f64"; case Elem::Record: return "record";
+    default: return "i32";
+  }
+}
+inline std::optional<Elem> parse_elem(std::string_view s) {
+  for (Elem e : {Elem::I32, Elem::I64, Elem::F32, Elem::F64, Elem::Record})
+    if (s == elem_name(e)) return e;
+  return std::nullopt;
+}
+
+// Instantiation list for the sort/dataset templates; keep in sync with Elem.
+#define ALGO_EVO_FOR_EACH_ELEM(X) X(int) X(int64_t) X(float) X(double) X(Record)
@@ -1,9 +1,13 @@
 #pragma once
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <vector>
 #include <string>
 #include "dna.hpp"
 #include "metrics.hpp"
+#include "elem.hpp"
+#include "sort_auto.hpp"
 
 // Input distributions
 enum class Dist { Uniform=0, NearlySorted=1, Reverse=2, Duplicates=3, Kaggle=4 };
@@ -17,18 +21,50 @@ struct EvalConfig {
   std::string kaggleCsvPath = "data/kaggle.csv";
   int jobs = 0;                 // 0 => auto (hardware threads)
   bool precompute = true;       // precompute base arrays and reuse
+  bool countOps = true;         // extra instrumented run per trial for comparisons/swaps
+  Elem elem = Elem::I32;        // element type the sorts are evaluated on
+  double memWeight = 0.0;       // fitness penalty per n-element buffer of scratch memory
 };
 
 struct EvalResult {
   double fitness_ms = 0.0;
   uint64_t comparisons = 0;
   uint64_t swaps = 0;
+  uint64_t aux_bytes = 0;       // peak scratch memory of the sort, worst trial
 };
 
 inline unsigned dist_mask_of(const std::vector<Dist>& v){
   unsigned m=0; for (auto d: v) m |= (1u<<int(d)); return m;
 }
 
+// The generated distribution a sort_auto feature bucket is trained on.
+inline Dist dist_for_class(InputClass c){
+  switch(c){
+    case InputClass::Presorted: return Dist::NearlySorted;
+    case InputClass::Reversed:  return Dist::Reverse;
+    case InputClass::FewUnique: return Dist::Duplicates;
+    default:                    return Dist::Uniform;
+  }
+}
+
 // Evaluate one DNA
 EvalResult eval_qs(const QSDNA& d, const EvalConfig& cfg);
 EvalResult eval_ms(const MSDNA& d, const EvalConfig& cfg);
+EvalResult eval_radix(const RadixDNA& d, const EvalConfig& cfg);
+EvalResult eval_sample(const SampleDNA& d, const EvalConfig& cfg);
+EvalResult eval_learned(const LearnedDNA& d, const EvalConfig& cfg);
+// sort_auto with the given table, so per-input selection is timed on the same
+// trials as a single DNA
+EvalResult eval_auto(const AutoTable& t, const EvalConfig& cfg);
+
+// Trains a sort_auto table: for every size bucket and input class, one GA per
+// algorithm family on that class's distribution (dist_for_class, generated
+// arrays only) at the bucket's n (train_n_for); the family whose evolved DNA
+// is fastest takes the slot. on_eval sees every GA evaluation with the config
+// it ran under; best_ms receives the winning fitness per slot.
+using AutoLogFn = std::function<void(InputClass c, const EvalConfig& ccfg, int step, int pop_idx,
+                                     const AutoChoice& dna, const EvalResult& r)>;
+using AutoTimes = std::array<std::array<double, kInputClasses>, kSizeClasses>;
+AutoTable train_auto_table(const EvalConfig& cfg, int pop, int gens,
+                           AutoLogFn on_eval = nullptr,
+                           AutoTimes* best_ms = nullptr);
@@ -0,0 +1,9 @@
+#pragma once
+#include <span>
+#include "metrics.hpp"
+#include "dna.hpp"
+
+// T is any element type from ALGO_EVO_FOR_EACH_ELEM (elem.hpp), ordered by
+// operator< (records by key); M is Metrics or NullMetrics. Not stable.
+template<class T, class M>
+void learned_sort(std::span<T> a, const LearnedDNA& dna, M& m);
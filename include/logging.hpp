@@ -4,16 +4,23 @@
 #include "dna.hpp"
 #include "evaluator.hpp"
 
-enum class Algo { QS, MS };
+enum class Algo { QS, MS, Radix, Sample, Learned }; // AnyDNA alternative order
 enum class Opt  { GA, SA };
 
 void write_csv_header(std::ostream& os);
 
+// The algo column and the family's gene columns come from the DNA's alternative.
 void write_csv_row(std::ostream& os,
                    const std::string& run_id, int step,
-                   Algo algo, Opt opt,
-                   const QSDNA* qs, const MSDNA* ms,
+                   Opt opt, const AnyDNA& dna,
                    const EvalResult& r,
                    std::size_t n, int trials_per_dist,
                    unsigned dist_mask, // bitmask of distributions used
+                   Elem elem,
                    int pop_idx, double temp);
+
+// C++ header declaring qs / ms as `inline constexpr` kTunedQS / kTunedMS (the
+// defaults when null) and, when given, the trained sort_auto table as
+// kTunedAuto; compiled into the tuned_sort library.
+void write_tuned_header(std::ostream& os, const std::string& run_id,
+                        const QSDNA* qs, const MSDNA* ms, const AutoTable* autoTable = nullptr);
@@ -0,0 +1,7 @@
+#pragma once
+#include <cstddef>
+
+// Merges sorted x[0,nx) and y[0,ny) into out[0,nx+ny). Uses the AVX2 bitonic
+// kernel when the CPU has it (see simd_level()), a branchless scalar loop
+// otherwise. Equal ints are interchangeable, so stability is not a concern.
+void simd_merge_int(const int* x, std::size_t nx, const int* y, std::size_t ny, int* out);
@@ -4,4 +4,12 @@
 #include "metrics.hpp"
 #include "dna.hpp"
 
-void mergesort(std::span<int> a, const MSDNA& dna, Metrics& m);
+// T is any element type from ALGO_EVO_FOR_EACH_ELEM (elem.hpp), ordered by
+// operator<; M is Metrics (counting) or NullMetrics (uninstrumented)
+template<class T, class M>
+void mergesort(std::span<T> a, const MSDNA& dna, M& m);
+
+// The same sort with every gene of V a compile-time constant (MSFixed, dna.hpp).
+// Only instantiated on kTunedMS, in the tuned_sort library (tuned_sort.hpp).
+template<MSDNA V, class T, class M>
+void mergesort_fixed(std::span<T> a, M& m);
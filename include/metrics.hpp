@@ -1,6 +1,28 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
+// Counting policy: every comparison and element move is tallied.
 struct Metrics {
   uint64_t comparisons = 0;
   uint64_t swaps = 0;
+  uint64_t auxBytes = 0;        // peak scratch memory held by the sort
 };
+using CountingMetrics = Metrics;
+
+// Zero-cost policy with the same interface; the counter updates compile away,
+// so timed runs measure the bare kernel.
+struct NullCounter {
+  constexpr NullCounter& operator++() { return *this; }
+  constexpr NullCounter& operator+=(uint64_t) { return *this; }
+  constexpr operator uint64_t() const { return 0; }
+};
+// auxBytes stays real: it changes once per allocation, not per element, and
+// the optimizer wants it from the timed run too.
+struct NullMetrics {
+  NullCounter comparisons, swaps;
+  uint64_t auxBytes = 0;
+};
+
+// Records that the sort holds `bytes` of scratch memory at some point.
+template<class M>
+inline void note_aux(M& m, uint64_t bytes) { m.auxBytes = std::max<uint64_t>(m.auxBytes, bytes); }
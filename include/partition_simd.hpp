@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+
+// Instruction set picked at runtime (CPUID) for the SIMD partition kernels
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+SimdLevel simd_level();
+const char* simd_level_name(SimdLevel s);
+
+// Partitions a[0,n) so that [0,b) < pivot and [b,n) >= pivot, returns b.
+// Dispatches once to the widest kernel the CPU supports.
+std::size_t simd_partition_less(int* a, std::size_t n, int pivot);
@@ -3,4 +3,13 @@
 #include "metrics.hpp"
 #include "dna.hpp"
 
-void quicksort(std::span<int> a, const QSDNA& dna, Metrics& m);
+// T is any element type from ALGO_EVO_FOR_EACH_ELEM (elem.hpp), ordered by
+// operator<; M is Metrics (counting) or NullMetrics (uninstrumented). All
+// combinations are instantiated in quicksort.cpp.
+template<class T, class M>
+void quicksort(std::span<T> a, const QSDNA& dna, M& m);
+
+// The same sort with every gene of V a compile-time constant (QSFixed, dna.hpp).
+// Only instantiated on kTunedQS, in the tuned_sort library (tuned_sort.hpp).
+template<QSDNA V, class T, class M>
+void quicksort_fixed(std::span<T> a, M& m);
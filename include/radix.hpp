@@ -0,0 +1,12 @@
+#pragma once
+#include <span>
+#include "metrics.hpp"
+#include "dna.hpp"
+
+// T is any element type from ALGO_EVO_FOR_EACH_ELEM (elem.hpp). Elements are
+// ordered through an unsigned key that preserves operator< (sign-flipped
+// integers, IEEE bit tricks for floats, Record::key for records). M is Metrics
+// or NullMetrics; swaps counts element moves, comparisons only come from the
+// comparison-sort fallback.
+template<class T, class M>
+void radix_sort(std::span<T> a, const RadixDNA& dna, M& m);
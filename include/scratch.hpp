@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <span>
+
+// Process-wide pool of scratch blocks. A sort leases one block for the length
+// of a call and hands it back on destruction, so repeated evaluations stop
+// paying for the allocation. (A thread_local buffer wouldn't do: run_all
+// starts every trial on a fresh std::async thread.) Idle blocks are capped
+// at 64 MiB in total, and blocks far larger than recent requests are freed
+// rather than kept.
+class ScratchLease {
+public:
+  explicit ScratchLease(std::size_t bytes);
+  ~ScratchLease();
+  ScratchLease(const ScratchLease&) = delete;
+  ScratchLease& operator=(const ScratchLease&) = delete;
+
+  // n elements of T over the leased bytes (T must be trivially copyable)
+  template<class T> std::span<T> as(std::size_t n) { return {reinterpret_cast<T*>(block_.get()), n}; }
+
+private:
+  std::unique_ptr<std::byte[]> block_;
+  std::size_t size_ = 0;
+};
+
+// Frees every idle pooled block, e.g. after a large one-off sort.
+void scratch_pool_trim();
+// Bytes currently held by idle pooled blocks.
+std::size_t scratch_pool_bytes();
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include "metrics.hpp"
+#include "dna.hpp"
+
+// T is any type from ALGO_EVO_FOR_EACH_ELEM (elem.hpp).
+
+// Largest slice the sorting networks handle; bigger ones use binary insertion.
+constexpr std::size_t kSmallNetworkMax = 32;
+
+// Base-case sort picked by the smallSortKind gene. `sentinel` may point at the
+// element right before `a` when it is <= every element of `a`; the unguarded
+// kernel then reads it instead of moving the minimum to the front first.
+template<class T, class M>
+void small_sort(std::span<T> a, SmallSort kind, M& m, const T* sentinel = nullptr);
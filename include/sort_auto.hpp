@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <variant>
+#include "metrics.hpp"
+#include "dna.hpp"
+
+// Features of an input, estimated from a few hundred sampled positions so the
+// probe stays O(1) next to the sort itself.
+struct InputFeatures {
+  std::size_t n = 0;      // picks the SizeClass
+  double ascending = 0;   // sampled adjacent pairs with a[i] < a[i+1]
+  double descending = 0;  // sampled adjacent pairs with a[i+1] < a[i]
+  double inversions = 0;  // sampled pairs i < j with a[j] < a[i]
+  double duplicates = 0;  // sorted sample: elements equal to their predecessor
+  uint64_t range = UINT64_MAX; // max - min of the sampled keys; integral keys only
+};
+
+// Feature buckets, one per generated distribution shape (see dist_for_class
+// in evaluator.hpp).
+enum class InputClass { Random, Presorted, Reversed, FewUnique };
+constexpr int kInputClasses = 4;
+
+// Size buckets: Small stays in L1/L2, where per-call overhead dominates;
+// Large is well past L2, where pass count and locality do.
+enum class SizeClass { Small, Medium, Large };
+constexpr int kSizeClasses = 3;
+constexpr std::size_t kMediumMin = std::size_t(1) << 12;
+constexpr std::size_t kLargeMin = std::size_t(1) << 18;
+
+using AutoChoice = AnyDNA;
+
+// What sort_auto runs for each input, indexed by SizeClass, then InputClass.
+struct AutoTable {
+  std::array<std::array<AutoChoice, kInputClasses>, kSizeClasses> bySize;
+};
+
+// Hand-picked defaults; --algo=auto in experiment trains a replacement.
+const AutoTable& default_auto_table();
+
+const char* input_class_name(InputClass c);
+const char* size_class_name(SizeClass s);
+InputClass classify_input(const InputFeatures& f);
+SizeClass size_class(std::size_t n);
+// The n a size bucket is trained at: n itself when it falls in the bucket,
+// else the bucket's nearest edge.
+std::size_t train_n_for(SizeClass s, std::size_t n);
+
+template<class T>
+InputFeatures estimate_features(std::span<const T> a);
+
+// Estimates the features of a, then runs the table entry for its size and class.
+template<class T, class M>
+void sort_auto(std::span<T> a, const AutoTable& table, M& m);
+
+template<class T>
+void sort_auto(std::span<T> a, const AutoTable& table = default_auto_table()) {
+  NullMetrics m;
+  sort_auto(a, table, m);
+}
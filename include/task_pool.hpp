@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool: every worker owns a deque, pushes/pops its own back and
+// steals from the front of the others. Threads outside the pool submit
+// round-robin and help out while they wait on a TaskGroup.
+class TaskPool {
+public:
+  explicit TaskPool(unsigned workers);
+  ~TaskPool();
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  unsigned workers() const { return unsigned(threads_.size()); }
+  void submit(std::function<void()> task);
+  // runs one queued task on the calling thread; false if nothing was available
+  bool run_one();
+
+private:
+  struct Queue { std::mutex mtx; std::deque<std::function<void()>> q; };
+  bool pop_or_steal(unsigned home, std::function<void()>& out);
+  void worker_loop(unsigned idx);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> stop_{false};
+  std::atomic<std::size_t> queued_{0};
+  std::atomic<unsigned> rr_{0};
+  std::mutex sleep_mtx_;
+  std::condition_variable cv_;
+};
+
+// Fork/join scope on a pool; wait() runs pending tasks instead of blocking,
+// so nested groups can't deadlock the pool. With a limit, at most that many of
+// the group's tasks are queued or running; run() executes further ones inline,
+// so the group keeps limit+1 cores busy counting the caller.
+class TaskGroup {
+public:
+  explicit TaskGroup(TaskPool& pool, std::size_t limit = 0) : pool_(pool), limit_(limit) {}
+  ~TaskGroup() { wait(); }
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  template<class F> void run(F&& f) {
+    if (limit_ && pending_.load(std::memory_order_relaxed) >= limit_) { f(); return; }
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pool_.submit([this, fn = std::forward<F>(f)]() mutable {
+      fn();
+      pending_.fetch_sub(1, std::memory_order_release);
+    });
+  }
+  void wait() {
+    while (pending_.load(std::memory_order_acquire) > 0)
+      if (!pool_.run_one()) std::this_thread::yield();
+  }
+  TaskPool& pool() { return pool_; }
+  std::size_t limit() const { return limit_; }
+
+private:
+  TaskPool& pool_;
+  std::size_t limit_;
+  std::atomic<std::size_t> pending_{0};
+};
+
+// Process-wide pool with hardware_concurrency()-1 workers, created on first use
+// and shared by every parallel sort. A sort with the `threads` gene t runs its
+// tasks in TaskGroups limited to t-1 (task_limit), so it uses at most t cores.
+TaskPool& shared_task_pool();
+inline std::size_t task_limit(unsigned threads) { return threads > 1 ? threads - 1 : 1; }
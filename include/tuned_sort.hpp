@@ -0,0 +1,18 @@
+#pragma once
+#include <span>
+#include "sort_auto.hpp"
+
+// Sorts with the DNA in the generated tuned_dna.hpp (experiment
+// --emit-header=), every gene a compile-time constant so no gene is dispatched
+// at run time. T is any element type from ALGO_EVO_FOR_EACH_ELEM (elem.hpp).
+// Link the tuned_sort library.
+template<class T>
+void tuned_quicksort(std::span<T> a);
+template<class T>
+void tuned_mergesort(std::span<T> a);
+
+// The sort_auto table trained by experiment --algo=auto when the header was
+// emitted from such a run, default_auto_table() otherwise.
+const AutoTable& tuned_auto_table();
+template<class T>
+void tuned_sort_auto(std::span<T> a);
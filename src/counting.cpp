@@ -0,0 +1,84 @@
+#include "counting.hpp"
+#include "scratch.hpp"
+#include "common.hpp"
+#include "elem.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+// Inputs shorter than this are left to the caller's own small-slice paths.
+constexpr size_t kCountingMin = 64;
+// Random elements probed before the full min/max pass; a wide range is
+// usually visible here, so ordinary inputs pay a few dozen loads.
+constexpr int kProbeSamples = 64;
+// The full pass checks the range after every block, so it stops early once
+// the input turns out to be too wide.
+constexpr size_t kProbeBlock = 4096;
+
+template<class T>
+constexpr bool kHasIntKey = std::is_integral_v<T> || std::is_same_v<T, Record>;
+
+template<class T>
+static inline auto count_key(const T& x) {
+  if constexpr (std::is_same_v<T, Record>) return x.key;
+  else return x;
+}
+
+template<class T, class M>
+bool counting_sort_small_range(std::span<T> a, int maxRange, M& m) {
+  if constexpr (!kHasIntKey<T>) {
+    return false;
+  } else {
+    using K = decltype(count_key(a[0]));
+    using U = std::make_unsigned_t<K>;
+    const size_t n = a.size();
+    if (maxRange <= 0 || n < kCountingMin) return false;
+    const U limit = U(maxRange);
+    K lo = count_key(a[0]), hi = lo;
+    XRand rng(n);
+    for (int i=0; i<kProbeSamples; ++i) {
+      const K k = count_key(a[rng.uniform(0, n-1)]);
+      lo = std::min(lo, k); hi = std::max(hi, k);
+    }
+    m.comparisons += 2 * kProbeSamples;
+    if (U(hi) - U(lo) >= limit) return false;
+    for (size_t b=0; b<n; b+=kProbeBlock) {
+      const size_t e = std::min(n, b + kProbeBlock);
+      for (size_t i=b; i<e; ++i) { const K k = count_key(a[i]); lo = std::min(lo, k); hi = std::max(hi, k); }
+      m.comparisons += 2 * (e - b);
+      if (U(hi) - U(lo) >= limit) return false;
+    }
+
+    const size_t R = size_t(U(hi) - U(lo)) + 1;
+    ScratchLease cntLease(R * sizeof(size_t));
+    std::span<size_t> cnt = cntLease.as<size_t>(R);
+    std::fill(cnt.begin(), cnt.end(), size_t(0));
+    for (const T& x : a) ++cnt[U(count_key(x)) - U(lo)];
+    if constexpr (std::is_integral_v<T>) {
+      // The values are the keys: write each one back cnt times.
+      note_aux(m, R * sizeof(size_t));
+      size_t i = 0;
+      for (size_t v=0; v<R; ++v) {
+        const T x = T(U(lo) + U(v));
+        for (size_t c=cnt[v]; c>0; --c) a[i++] = x;
+      }
+      m.swaps += n;
+    } else {
+      // Records carry a payload: stable scatter by key into scratch.
+      note_aux(m, R * sizeof(size_t) + n * sizeof(T));
+      ScratchLease buf(n * sizeof(T));
+      std::span<T> tmp = buf.as<T>(n);
+      size_t sum = 0;
+      for (size_t& c : cnt) { const size_t k = c; c = sum; sum += k; }
+      for (const T& x : a) tmp[cnt[U(count_key(x)) - U(lo)]++] = x;
+      std::copy(tmp.begin(), tmp.end(), a.begin());
+      m.swaps += 2 * n;
+    }
+    return true;
+  }
+}
+
+#define COUNTING_INSTANTIATE(T) \
+  template bool counting_sort_small_range<T, Metrics>(std::span<T>, int, Metrics&); \
+  template bool counting_sort_small_range<T, NullMetrics>(std::span<T>, int, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(COUNTING_INSTANTIATE)
@@ -1,15 +1,17 @@
 #include "datasets.hpp"
 #include "evaluator.hpp"  // for thee Dist enum definition
 #include "common.hpp"
+#include "elem.hpp"
 #include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <charconv>
 #include <cmath>
 
-static std::vector<int> nearly_sorted(std::size_t n, uint64_t seed) {
-  std::vector<int> a(n);
-  for (size_t i=0;i<n;++i) a[i] = int(i);
+template<class T>
+static std::vector<T> nearly_sorted(std::size_t n, uint64_t seed) {
+  std::vector<T> a(n);
+  for (size_t i=0;i<n;++i) a[i] = ElemTraits<T>::from_int(int64_t(i), i);
   XRand rng(seed);
   size_t swaps = std::max<std::size_t>(1, n/100); // ~1%
   for (size_t k=0;k<swaps;++k) {
@@ -18,22 +20,25 @@ static std::vector<int> nearly_sorted(std::size_t n, uint64_t seed) {
   }
   return a;
 }
-static std::vector<int> reverse_sorted(std::size_t n) {
-  std::vector<int> a(n);
-  for (size_t i=0;i<n;++i) a[i] = int(n-1-i);
+template<class T>
+static std::vector<T> reverse_sorted(std::size_t n) {
+  std::vector<T> a(n);
+  for (size_t i=0;i<n;++i) a[i] = ElemTraits<T>::from_int(int64_t(n-1-i), i);
   return a;
 }
-static std::vector<int> many_dups(std::size_t n, uint64_t seed) {
+template<class T>
+static std::vector<T> many_dups(std::size_t n, uint64_t seed) {
   XRand rng(seed);
-  std::vector<int> a(n);
+  std::vector<T> a(n);
   int k = 100; // limited value range
-  for (size_t i=0;i<n;++i) a[i] = int(rng.uniform(0, k-1));
+  for (size_t i=0;i<n;++i) a[i] = ElemTraits<T>::from_int(int64_t(rng.uniform(0, k-1)), i);
   return a;
 }
-static std::vector<int> uniform_random(std::size_t n, uint64_t seed) {
+template<class T>
+static std::vector<T> uniform_random(std::size_t n, uint64_t seed) {
   XRand rng(seed);
-  std::vector<int> a(n);
-  for (size_t i=0;i<n;++i) a[i] = int(rng.next() & 0x7fffffff);
+  std::vector<T> a(n);
+  for (size_t i=0;i<n;++i) a[i] = ElemTraits<T>::from_random(rng.next(), i);
   return a;
 }
 std::vector<int> load_kaggle_column_as_ints(const std::string& csv_path, std::size_t n) {
@@ -85,13 +90,27 @@ std::vector<int> load_kaggle_column_as_ints(const std::string& csv_path, std::si
   return vals;
 }
 
-std::vector<int> make_array(std::size_t n, Dist d, uint64_t seed) {
+template<class T>
+std::vector<T> load_kaggle_column_as(const std::string& csv_path, std::size_t n) {
+  std::vector<int> vals = load_kaggle_column_as_ints(csv_path, n);
+  std::vector<T> out(vals.size());
+  for (size_t i=0;i<vals.size();++i) out[i] = ElemTraits<T>::from_int(vals[i], i);
+  return out;
+}
+
+template<class T>
+std::vector<T> make_array(std::size_t n, Dist d, uint64_t seed) {
   switch (d) {
-    case Dist::Uniform:      return uniform_random(n, seed);
-    case Dist::NearlySorted: return nearly_sorted(n, seed);
-    case Dist::Reverse:      return reverse_sorted(n);
-    case Dist::Duplicates:   return many_dups(n, seed);
-    case Dist::Kaggle:       return load_kaggle_column_as_ints("data/kaggle.csv", n);
+    case Dist::Uniform:      return uniform_random<T>(n, seed);
+    case Dist::NearlySorted: return nearly_sorted<T>(n, seed);
+    case Dist::Reverse:      return reverse_sorted<T>(n);
+    case Dist::Duplicates:   return many_dups<T>(n, seed);
+    case Dist::Kaggle:       return load_kaggle_column_as<T>("data/kaggle.csv", n);
   }
-  return uniform_random(n, seed);
+  return uniform_random<T>(n, seed);
 }
+
+#define DATASETS_INSTANTIATE(T) \
+  template std::vector<T> make_array<T>(std::size_t, Dist, uint64_t); \
+  template std::vector<T> load_kaggle_column_as<T>(const std::string&, std::size_t);
+ALGO_EVO_FOR_EACH_ELEM(DATASETS_INSTANTIATE)
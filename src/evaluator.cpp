@@ -2,19 +2,26 @@
 #include "datasets.hpp"
 #include "quicksort.hpp"
 #include "mergesort.hpp"
+#include "radix.hpp"
+#include "samplesort.hpp"
+#include "learned.hpp"
 #include "common.hpp"
+#include "ga.hpp"
 #include <future>
+#include <thread>
 #include <mutex>
 #include <numeric>
 #include <cmath>
+#include <limits>
 #include <unordered_map>
 
 using std::vector;
 // precompute caching for efficiency
+// (one cache per element type, so the key doesn't need the type)
 struct PrecompKey {
-  uint64_t n; int trials; uint64_t seed; bool kaggle;
+  uint64_t n; int trials; uint64_t seed; bool kaggle; unsigned dists;
   bool operator==(const PrecompKey& o) const {
-    return n==o.n && trials==o.trials && seed==o.seed && kaggle==o.kaggle;
+    return n==o.n && trials==o.trials && seed==o.seed && kaggle==o.kaggle && dists==o.dists;
   }
 };
 struct PrecompKeyHash {
@@ -23,34 +30,38 @@ struct PrecompKeyHash {
     h ^= std::hash<uint64_t>{}(k.seed + 0x9e3779b97f4a7c15ull + (h<<6)+(h>>2));
     h ^= std::hash<int>{}(k.trials + 13);
     h ^= std::hash<bool>{}(k.kaggle + 29);
+    h ^= std::hash<unsigned>{}(k.dists) << 1;
     return h;
   }
 };
 // for each of the dist,trial pairs we store base array that is reused and copied
+template<class T>
 struct PrecompSet {
   // map Dist -> base arrays [trial]
-  std::unordered_map<int, vector<vector<int>>> base;
+  std::unordered_map<int, vector<vector<T>>> base;
 };
 static std::mutex g_pre_mtx;
-static std::unordered_map<PrecompKey, PrecompSet, PrecompKeyHash> g_pre;
-static const PrecompSet& get_pre(const EvalConfig& cfg){
-  if (!cfg.precompute) { static PrecompSet dummy; return dummy; }
-  PrecompKey key{cfg.n, cfg.trialsPerDist, cfg.masterSeed, cfg.useKaggle};
+template<class T>
+static std::unordered_map<PrecompKey, PrecompSet<T>, PrecompKeyHash> g_pre;
+template<class T>
+static const PrecompSet<T>& get_pre(const EvalConfig& cfg){
+  if (!cfg.precompute) { static PrecompSet<T> dummy; return dummy; }
+  PrecompKey key{cfg.n, cfg.trialsPerDist, cfg.masterSeed, cfg.useKaggle, dist_mask_of(cfg.dists)};
   std::scoped_lock lk(g_pre_mtx);
-  auto it = g_pre.find(key);
-  if (it != g_pre.end()) return it->second;
+  auto it = g_pre<T>.find(key);
+  if (it != g_pre<T>.end()) return it->second;
   // builds new
-  PrecompSet set;
+  PrecompSet<T> set;
   XRand rng(cfg.masterSeed);
   auto make_all_for = [&](Dist d){
-    vector<vector<int>> vv(cfg.trialsPerDist);
+    vector<vector<T>> vv(cfg.trialsPerDist);
     for (int t=0; t<cfg.trialsPerDist; ++t){
       uint64_t seed = cfg.masterSeed + 1337ull*uint64_t(d) + uint64_t(t);
-      vector<int> arr;
+      vector<T> arr;
       if (d == Dist::Kaggle && cfg.useKaggle) {
-        arr = load_kaggle_column_as_ints(cfg.kaggleCsvPath, cfg.n);
+        arr = load_kaggle_column_as<T>(cfg.kaggleCsvPath, cfg.n);
       } else {
-        arr = make_array(cfg.n, d, seed);
+        arr = make_array<T>(cfg.n, d, seed);
       }
       vv[t] = std::move(arr);
     }
@@ -58,7 +69,7 @@ static const PrecompSet& get_pre(const EvalConfig& cfg){
   };
   for (auto d: cfg.dists) make_all_for(d);
   if (cfg.useKaggle) make_all_for(Dist::Kaggle);
-  auto [it2, _] = g_pre.emplace(key, std::move(set));
+  auto [it2, _] = g_pre<T>.emplace(key, std::move(set));
   return it2->second;
 }
 // helpers for program
@@ -66,81 +77,172 @@ struct Accum {
   double geo_sum = 0.0; // sum of the log(ms)
   int count = 0;
   uint64_t comps = 0, swaps = 0;
+  uint64_t aux = 0;     // largest auxiliary footprint over the trials
 };
 static inline double geo_mean_from_logsum(double s, int n){
   return std::exp(s / std::max(1,n));
 }
-template<class SortFn>
-static EvalResult run_all(const EvalConfig& cfg, SortFn sortOne){
-  const int jobs = (cfg.jobs>0) ? cfg.jobs : std::max(1u, std::thread::hardware_concurrency());
-  const auto& pre = get_pre(cfg);
+template<class T, class SortFn>
+static EvalResult run_all(const EvalConfig& cfg, SortFn sortOne, int maxJobs = 0){
+  int jobs = (cfg.jobs>0) ? cfg.jobs : (int)std::max(1u, std::thread::hardware_concurrency());
+  if (maxJobs > 0) jobs = std::min(jobs, maxJobs);
+  const auto& pre = get_pre<T>(cfg);
   vector<std::future<Accum>> futs;
   futs.reserve(cfg.dists.size()*cfg.trialsPerDist);
   auto submit = [&](Dist d, int t){
     return std::async(std::launch::async, [&,d,t]()->Accum{
       Accum A{};
-      vector<int> work; work.resize(cfg.n);
-      // copy base
-      if (cfg.precompute) {
-        const auto& base = pre.base.at(int(d))[t];
-        std::copy(base.begin(), base.end(), work.begin());
-      } else {
+      vector<T> generated;
+      if (!cfg.precompute) {
         // generates
         uint64_t seed = cfg.masterSeed + 1337ull*uint64_t(d) + uint64_t(t);
         if (d == Dist::Kaggle && cfg.useKaggle) {
-          work = load_kaggle_column_as_ints(cfg.kaggleCsvPath, cfg.n);
+          generated = load_kaggle_column_as<T>(cfg.kaggleCsvPath, cfg.n);
         } else {
-          work = make_array(cfg.n, d, seed);
+          generated = make_array<T>(cfg.n, d, seed);
         }
-
       }
+      const vector<T>& base = cfg.precompute ? pre.base.at(int(d))[t] : generated;
+      vector<T> work(base.begin(), base.end());
       // warm up implementation **its not timed
       { vector<int> tmp(128); for (int i=0;i<128;i++) tmp[i]=128-i; volatile int sink=tmp[0]; (void)sink; }
-      Metrics m{};
+      // the timed run is uninstrumented so counter updates don't skew fitness
+      NullMetrics nm{};
       auto t0 = now_ns();
-      sortOne(work, m); // runs algo
+      sortOne(work, nm); // runs algo
       auto t1 = now_ns();
       double ms = double(t1 - t0) / 1e6;
       A.geo_sum += std::log(std::max(1e-9, ms));
       A.count += 1;
-      A.comps += m.comparisons;
-      A.swaps += m.swaps;
+      A.aux = std::max<uint64_t>(A.aux, nm.auxBytes);
+      if (cfg.countOps) {
+        // counts come from a separate untimed run on the same input
+        std::copy(base.begin(), base.end(), work.begin());
+        Metrics m{};
+        sortOne(work, m);
+        A.comps += m.comparisons;
+        A.swaps += m.swaps;
+      }
       return A;
     });
   };
-  // launch all of the jobs
+  vector<std::pair<Dist,int>> work;
   for (auto d: cfg.dists)
     for (int t=0; t<cfg.trialsPerDist; ++t)
-      futs.push_back(submit(d,t));
+      work.push_back({d,t});
   if (cfg.useKaggle)
     for (int t=0; t<cfg.trialsPerDist; ++t)
-      futs.push_back(submit(Dist::Kaggle,t));
+      work.push_back({Dist::Kaggle,t});
 
+  // launch the jobs in waves of at most `jobs` concurrent trials
   Accum total{};
-  for (auto& f : futs){
-    Accum a = f.get();
-    total.geo_sum += a.geo_sum;
-    total.count   += a.count;
-    total.comps   += a.comps;
-    total.swaps   += a.swaps;
+  for (size_t w=0; w<work.size(); w+=jobs){
+    futs.clear();
+    for (size_t i=w; i<std::min(work.size(), w+jobs); ++i)
+      futs.push_back(submit(work[i].first, work[i].second));
+    for (auto& f : futs){
+      Accum a = f.get();
+      total.geo_sum += a.geo_sum;
+      total.count   += a.count;
+      total.comps   += a.comps;
+      total.swaps   += a.swaps;
+      total.aux      = std::max(total.aux, a.aux);
+    }
   }
 
   EvalResult r{};
   r.fitness_ms = geo_mean_from_logsum(total.geo_sum, total.count);
+  r.aux_bytes = total.aux;
+  // trade time against memory: each n-element buffer's worth of scratch
+  // adds memWeight to the relative cost
+  if (cfg.memWeight > 0 && cfg.n > 0)
+    r.fitness_ms *= 1.0 + cfg.memWeight * double(total.aux) / double(cfg.n * sizeof(T));
   r.comparisons = total.comps / std::max(1,total.count); // average counters
   r.swaps       = total.swaps / std::max(1,total.count);
   return r;
 }
+// runs the trials on the element type picked by cfg.elem
+template<class SortFn>
+static EvalResult run_all_elem(const EvalConfig& cfg, SortFn sortOne, int maxJobs = 0){
+  switch (cfg.elem) {
+    case Elem::I64:    return run_all<int64_t>(cfg, sortOne, maxJobs);
+    case Elem::F32:    return run_all<float>(cfg, sortOne, maxJobs);
+    case Elem::F64:    return run_all<double>(cfg, sortOne, maxJobs);
+    case Elem::Record: return run_all<Record>(cfg, sortOne, maxJobs);
+    default:           return run_all<int>(cfg, sortOne, maxJobs);
+  }
+}
 // public entry points to be used
 EvalResult eval_qs(const QSDNA& d, const EvalConfig& cfg){
-  auto runOne = [&](vector<int>& a, Metrics& m){
-    quicksort(std::span<int>(a.data(), a.size()), d, m);
+  auto runOne = [&](auto& a, auto& m){
+    quicksort(std::span(a.data(), a.size()), d, m);
   };
-  return run_all(cfg, runOne);
+  // a multi-threaded sort owns the machine; run its trials one at a time
+  return run_all_elem(cfg, runOne, d.threads > 1 ? 1 : 0);
 }
 EvalResult eval_ms(const MSDNA& d, const EvalConfig& cfg){
-  auto runOne = [&](vector<int>& a, Metrics& m){
-    mergesort(std::span<int>(a.data(), a.size()), d, m);
+  auto runOne = [&](auto& a, auto& m){
+    mergesort(std::span(a.data(), a.size()), d, m);
   };
-  return run_all(cfg, runOne);
+  return run_all_elem(cfg, runOne, d.threads > 1 ? 1 : 0);
+}
+EvalResult eval_radix(const RadixDNA& d, const EvalConfig& cfg){
+  auto runOne = [&](auto& a, auto& m){
+    radix_sort(std::span(a.data(), a.size()), d, m);
+  };
+  return run_all_elem(cfg, runOne);
+}
+EvalResult eval_sample(const SampleDNA& d, const EvalConfig& cfg){
+  auto runOne = [&](auto& a, auto& m){
+    samplesort(std::span(a.data(), a.size()), d, m);
+  };
+  return run_all_elem(cfg, runOne, d.threads > 1 ? 1 : 0);
+}
+EvalResult eval_learned(const LearnedDNA& d, const EvalConfig& cfg){
+  auto runOne = [&](auto& a, auto& m){
+    learned_sort(std::span(a.data(), a.size()), d, m);
+  };
+  return run_all_elem(cfg, runOne);
+}
+EvalResult eval_auto(const AutoTable& t, const EvalConfig& cfg){
+  bool threaded = false;
+  for (const auto& row : t.bySize)
+    for (const auto& c : row)
+      std::visit([&](const auto& d){
+        if constexpr (requires { d.threads; }) threaded |= d.threads > 1;
+      }, c);
+  auto runOne = [&](auto& a, auto& m){
+    sort_auto(std::span(a.data(), a.size()), t, m);
+  };
+  return run_all_elem(cfg, runOne, threaded ? 1 : 0);
+}
+
+AutoTable train_auto_table(const EvalConfig& cfg, int pop, int gens,
+                           AutoLogFn on_eval, AutoTimes* best_ms){
+  AutoTable table = default_auto_table();
+  for (int s = 0; s < kSizeClasses; ++s)
+  for (int c = 0; c < kInputClasses; ++c) {
+    EvalConfig ccfg = cfg;
+    ccfg.n = train_n_for((SizeClass)s, cfg.n);
+    ccfg.dists = {dist_for_class((InputClass)c)};
+    ccfg.useKaggle = false;
+    double best = std::numeric_limits<double>::infinity();
+    auto train = [&](auto tag, auto evalOne){
+      using DNA = decltype(tag);
+      LogFn<DNA> log = nullptr;
+      if (on_eval) log = [&](int step, int pop_idx, const DNA& d, const EvalResult& r, double){
+        on_eval((InputClass)c, ccfg, step, pop_idx, AutoChoice(d), r);
+      };
+      DNA dna = run_ga<DNA>([&](const DNA& d){ return evalOne(d, ccfg); }, pop, gens, cfg.masterSeed, nullptr, log);
+      double f = evalOne(dna, ccfg).fitness_ms;
+      if (f < best) { best = f; table.bySize[s][c] = dna; }
+    };
+    train(QSDNA{}, eval_qs);
+    train(MSDNA{}, eval_ms);
+    train(RadixDNA{}, eval_radix);
+    train(SampleDNA{}, eval_sample);
+    train(LearnedDNA{}, eval_learned);
+    if (best_ms) (*best_ms)[s][c] = best;
+  }
+  return table;
 }
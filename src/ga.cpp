@@ -1,20 +1,66 @@
 #include "ga.hpp"
 #include "common.hpp"
 #include <algorithm>
+#include <thread>
 // mutations and crossover helpers 
+static int max_threads() { return (int)std::max(1u, std::thread::hardware_concurrency()); }
 template<class DNA> static DNA mutateDNA(DNA d, XRand& rng);
 template<> QSDNA mutateDNA(QSDNA d, XRand& rng) {
-  if (rng.uniform01() < 0.20) d.pivot = (Pivot) (rng.uniform(0,2));
-  if (rng.uniform01() < 0.20) d.scheme = (PartitionScheme) (rng.uniform(0,1));
+  if (rng.uniform01() < 0.20) d.pivot = (Pivot) (rng.uniform(0,5));
+  if (rng.uniform01() < 0.20) d.scheme = (PartitionScheme) (rng.uniform(0,4));
   if (rng.uniform01() < 0.40) d.insertionCutoff = std::clamp(d.insertionCutoff + int(rng.uniform(0,7))-3, 0, 64);
   if (rng.uniform01() < 0.40) d.depthCap       = std::clamp(d.depthCap       + int(rng.uniform(0,7))-3, 32, 128);
+  if (rng.uniform01() < 0.20) d.smallSortKind = (SmallSort) (rng.uniform(0,3));
+  if (rng.uniform01() < 0.20) d.countingThreshold = std::clamp(rng.uniform(0,1) ? std::max(64, d.countingThreshold)*2 : d.countingThreshold/2, 0, 1<<20);
   if (rng.uniform01() < 0.30) d.tailRecElim = !d.tailRecElim;
+  if (rng.uniform01() < 0.20) d.pivotCount = int(rng.uniform(1,3));
+  if (rng.uniform01() < 0.20) d.depthFallback = (DepthFallback) (rng.uniform(0,2));
+  if (rng.uniform01() < 0.20) d.equalLeft = !d.equalLeft;
+  if (rng.uniform01() < 0.20) d.presortCheck = !d.presortCheck;
+  if (rng.uniform01() < 0.20) d.patternShuffle = !d.patternShuffle;
+  if (rng.uniform01() < 0.20) d.threads = std::clamp(d.threads + int(rng.uniform(0,2))-1, 1, max_threads());
+  if (rng.uniform01() < 0.20) d.parallelGrain = std::clamp(rng.uniform(0,1) ? d.parallelGrain*2 : d.parallelGrain/2, 1024, 1<<20);
   return d;
 }
 template<> MSDNA mutateDNA(MSDNA d, XRand& rng) {
   if (rng.uniform01() < 0.40) d.runThreshold = std::clamp(d.runThreshold + int(rng.uniform(0,7))-3, 0, 64);
   if (rng.uniform01() < 0.20) d.iterative   = !d.iterative;
   if (rng.uniform01() < 0.20) d.reuseBuffer = !d.reuseBuffer;
+  if (rng.uniform01() < 0.20) d.buffer = (MergeBuffer) (rng.uniform(0,1));
+  if (rng.uniform01() < 0.20) d.mergeKernel = (MergeKernel) (rng.uniform(0,2));
+  if (rng.uniform01() < 0.20) d.natural = !d.natural;
+  if (rng.uniform01() < 0.20) d.minRun = std::clamp(d.minRun + int(rng.uniform(0,8))-4, 8, 64);
+  if (rng.uniform01() < 0.20) d.minGallop = std::clamp(d.minGallop + int(rng.uniform(0,4))-2, 1, 64);
+  if (rng.uniform01() < 0.20) d.mergeArity = std::clamp(rng.uniform(0,1) ? d.mergeArity*2 : d.mergeArity/2, 2, 16);
+  if (rng.uniform01() < 0.20) d.inPlace = !d.inPlace;
+  if (rng.uniform01() < 0.20) d.inPlaceBuffer = std::clamp(rng.uniform(0,1) ? std::max(1, d.inPlaceBuffer)*2 : d.inPlaceBuffer/2, 0, 4096);
+  if (rng.uniform01() < 0.20) d.threads = std::clamp(d.threads + int(rng.uniform(0,2))-1, 1, max_threads());
+  if (rng.uniform01() < 0.20) d.parallelGrain = std::clamp(rng.uniform(0,1) ? d.parallelGrain*2 : d.parallelGrain/2, 1024, 1<<20);
+  if (rng.uniform01() < 0.20) d.smallSortKind = (SmallSort) (rng.uniform(0,2)); // no Network: not stable
+  if (rng.uniform01() < 0.20) d.countingThreshold = std::clamp(rng.uniform(0,1) ? std::max(64, d.countingThreshold)*2 : d.countingThreshold/2, 0, 1<<20);
+  return d;
+}
+template<> RadixDNA mutateDNA(RadixDNA d, XRand& rng) {
+  if (rng.uniform01() < 0.40) d.digitBits = std::clamp(d.digitBits + int(rng.uniform(0,4))-2, 4, 16);
+  if (rng.uniform01() < 0.20) d.order = (RadixOrder) (rng.uniform(0,1));
+  if (rng.uniform01() < 0.20) d.inPlace = !d.inPlace;
+  if (rng.uniform01() < 0.30) d.fallbackThreshold = std::clamp(rng.uniform(0,1) ? std::max(1, d.fallbackThreshold)*2 : d.fallbackThreshold/2, 0, 4096);
+  if (rng.uniform01() < 0.20) d.prefetch = !d.prefetch;
+  return d;
+}
+template<> SampleDNA mutateDNA(SampleDNA d, XRand& rng) {
+  if (rng.uniform01() < 0.30) d.buckets = std::clamp(rng.uniform(0,1) ? d.buckets*2 : d.buckets/2, 4, 256);
+  if (rng.uniform01() < 0.30) d.oversample = std::clamp(d.oversample + int(rng.uniform(0,4))-2, 1, 32);
+  if (rng.uniform01() < 0.20) d.baseCase = (SampleBase) (rng.uniform(0,2));
+  if (rng.uniform01() < 0.30) d.baseThreshold = std::clamp(rng.uniform(0,1) ? d.baseThreshold*2 : d.baseThreshold/2, 256, 65536);
+  if (rng.uniform01() < 0.20) d.threads = std::clamp(d.threads + int(rng.uniform(0,2))-1, 1, max_threads());
+  if (rng.uniform01() < 0.20) d.parallelGrain = std::clamp(rng.uniform(0,1) ? d.parallelGrain*2 : d.parallelGrain/2, 1024, 1<<20);
+  return d;
+}
+template<> LearnedDNA mutateDNA(LearnedDNA d, XRand& rng) {
+  if (rng.uniform01() < 0.30) d.samplePermille = std::clamp(d.samplePermille + int(rng.uniform(0,8))-4, 1, 100);
+  if (rng.uniform01() < 0.30) d.segments = std::clamp(rng.uniform(0,1) ? d.segments*2 : d.segments/2, 16, 4096);
+  if (rng.uniform01() < 0.30) d.fanout = std::clamp(rng.uniform(0,1) ? d.fanout*2 : d.fanout/2, 16, 4096);
   return d;
 }
 template<class DNA> static DNA crossover(const DNA& a, const DNA& b, XRand& rng);
@@ -24,7 +70,16 @@ template<> QSDNA crossover(const QSDNA& a, const QSDNA& b, XRand&) {
   if (XRand(0).uniform01() < 0.5) c.scheme = b.scheme;
   if (XRand(0).uniform01() < 0.5) c.insertionCutoff = b.insertionCutoff;
   if (XRand(0).uniform01() < 0.5) c.depthCap = b.depthCap;
+  if (XRand(0).uniform01() < 0.5) c.smallSortKind = b.smallSortKind;
+  if (XRand(0).uniform01() < 0.5) c.countingThreshold = b.countingThreshold;
   if (XRand(0).uniform01() < 0.5) c.tailRecElim = b.tailRecElim;
+  if (XRand(0).uniform01() < 0.5) c.pivotCount = b.pivotCount;
+  if (XRand(0).uniform01() < 0.5) c.depthFallback = b.depthFallback;
+  if (XRand(0).uniform01() < 0.5) c.equalLeft = b.equalLeft;
+  if (XRand(0).uniform01() < 0.5) c.presortCheck = b.presortCheck;
+  if (XRand(0).uniform01() < 0.5) c.patternShuffle = b.patternShuffle;
+  if (XRand(0).uniform01() < 0.5) c.threads = b.threads;
+  if (XRand(0).uniform01() < 0.5) c.parallelGrain = b.parallelGrain;
   return c;
 }
 template<> MSDNA crossover(const MSDNA& a, const MSDNA& b, XRand&) {
@@ -32,6 +87,44 @@ template<> MSDNA crossover(const MSDNA& a, const MSDNA& b, XRand&) {
   if (XRand(0).uniform01() < 0.5) c.runThreshold = b.runThreshold;
   if (XRand(0).uniform01() < 0.5) c.iterative = b.iterative;
   if (XRand(0).uniform01() < 0.5) c.reuseBuffer = b.reuseBuffer;
+  if (XRand(0).uniform01() < 0.5) c.buffer = b.buffer;
+  if (XRand(0).uniform01() < 0.5) c.mergeKernel = b.mergeKernel;
+  if (XRand(0).uniform01() < 0.5) c.natural = b.natural;
+  if (XRand(0).uniform01() < 0.5) c.minRun = b.minRun;
+  if (XRand(0).uniform01() < 0.5) c.minGallop = b.minGallop;
+  if (XRand(0).uniform01() < 0.5) c.mergeArity = b.mergeArity;
+  if (XRand(0).uniform01() < 0.5) c.inPlace = b.inPlace;
+  if (XRand(0).uniform01() < 0.5) c.inPlaceBuffer = b.inPlaceBuffer;
+  if (XRand(0).uniform01() < 0.5) c.threads = b.threads;
+  if (XRand(0).uniform01() < 0.5) c.parallelGrain = b.parallelGrain;
+  if (XRand(0).uniform01() < 0.5) c.smallSortKind = b.smallSortKind;
+  if (XRand(0).uniform01() < 0.5) c.countingThreshold = b.countingThreshold;
+  return c;
+}
+template<> RadixDNA crossover(const RadixDNA& a, const RadixDNA& b, XRand&) {
+  RadixDNA c = a;
+  if (XRand(0).uniform01() < 0.5) c.digitBits = b.digitBits;
+  if (XRand(0).uniform01() < 0.5) c.order = b.order;
+  if (XRand(0).uniform01() < 0.5) c.inPlace = b.inPlace;
+  if (XRand(0).uniform01() < 0.5) c.fallbackThreshold = b.fallbackThreshold;
+  if (XRand(0).uniform01() < 0.5) c.prefetch = b.prefetch;
+  return c;
+}
+template<> SampleDNA crossover(const SampleDNA& a, const SampleDNA& b, XRand&) {
+  SampleDNA c = a;
+  if (XRand(0).uniform01() < 0.5) c.buckets = b.buckets;
+  if (XRand(0).uniform01() < 0.5) c.oversample = b.oversample;
+  if (XRand(0).uniform01() < 0.5) c.baseCase = b.baseCase;
+  if (XRand(0).uniform01() < 0.5) c.baseThreshold = b.baseThreshold;
+  if (XRand(0).uniform01() < 0.5) c.threads = b.threads;
+  if (XRand(0).uniform01() < 0.5) c.parallelGrain = b.parallelGrain;
+  return c;
+}
+template<> LearnedDNA crossover(const LearnedDNA& a, const LearnedDNA& b, XRand&) {
+  LearnedDNA c = a;
+  if (XRand(0).uniform01() < 0.5) c.samplePermille = b.samplePermille;
+  if (XRand(0).uniform01() < 0.5) c.segments = b.segments;
+  if (XRand(0).uniform01() < 0.5) c.fanout = b.fanout;
   return c;
 }
 // ga evaluator implementationn
@@ -91,3 +184,6 @@ DNA run_ga(EvalFn<DNA> eval, int pop, int gens, uint64_t seed,
 }
 template QSDNA run_ga<QSDNA>(EvalFn<QSDNA>, int, int, uint64_t, std::vector<std::vector<double>>*, LogFn<QSDNA>);
 template MSDNA run_ga<MSDNA>(EvalFn<MSDNA>, int, int, uint64_t, std::vector<std::vector<double>>*, LogFn<MSDNA>);
+template RadixDNA run_ga<RadixDNA>(EvalFn<RadixDNA>, int, int, uint64_t, std::vector<std::vector<double>>*, LogFn<RadixDNA>);
+template SampleDNA run_ga<SampleDNA>(EvalFn<SampleDNA>, int, int, uint64_t, std::vector<std::vector<double>>*, LogFn<SampleDNA>);
+template LearnedDNA run_ga<LearnedDNA>(EvalFn<LearnedDNA>, int, int, uint64_t, std::vector<std::vector<double>>*, LogFn<LearnedDNA>);
@@ -0,0 +1,139 @@
+#include "learned.hpp"
+#include "quicksort.hpp"
+#include "small_sort.hpp"
+#include "scratch.hpp"
+#include "common.hpp"
+#include "elem.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Below this the model costs more than it saves.
+constexpr size_t kLearnedMin = 1024;
+// Elements sharing a predicted slot are fixed up by insertion sort up to this
+// size, by quicksort above (only when the model is far off, or on duplicates).
+constexpr size_t kFixupInsertionMax = 32;
+
+template<class T>
+static inline double model_key(const T& x) {
+  if constexpr (std::is_same_v<T, Record>) return double(x.key);
+  else return double(x);
+}
+
+// Two-level piecewise-linear CDF: the root splits [lo, hi] of the sample into
+// equal-width segments, each segment interpolates linearly between the ranks
+// of its first and last sample. Every segment's output is clamped to its own
+// rank range, so the model is monotone and the placement keeps order between
+// different predictions.
+struct CdfModel {
+  struct Segment { double xlo, slope, base, top; };
+  double lo = 0, scale = 0, last = 0;
+  std::vector<Segment> seg;
+
+  // keys: the sorted sample. Returns false when the sample is a single value.
+  bool fit(const std::vector<double>& keys, size_t segments) {
+    const size_t S = keys.size();
+    lo = keys.front();
+    const double hi = keys.back();
+    if (!(hi > lo)) return false;
+    seg.assign(segments, Segment{});
+    scale = double(segments) / (hi - lo);
+    last = double(segments - 1);
+    size_t i = 0;
+    for (size_t s=0; s<segments; ++s) {
+      const size_t i0 = i;
+      while (i < S && segment_of(keys[i]) == s) ++i;
+      Segment& g = seg[s];
+      g.base = double(i0) / double(S);
+      g.top = double(i) / double(S);
+      g.xlo = i > i0 ? keys[i0] : 0.0;
+      g.slope = (i - i0 > 1 && keys[i-1] > keys[i0]) ? (g.top - g.base) / (keys[i-1] - keys[i0]) : 0.0;
+    }
+    return true;
+  }
+  size_t segment_of(double x) const {
+    const double r = (x - lo) * scale;
+    return r > 0 ? size_t(r < last ? r : last) : 0;
+  }
+  // Predicted CDF in [0, 1]; NaN-safe through the comparisons.
+  double operator()(double x) const {
+    const Segment& g = seg[segment_of(x)];
+    const double c = g.base + (x - g.xlo) * g.slope;
+    return c > g.base ? (c < g.top ? c : g.top) : g.base;
+  }
+};
+
+template<class T, class M>
+void learned_sort(std::span<T> a, const LearnedDNA& dna, M& m) {
+  const size_t n = a.size();
+  if (n < kLearnedMin) { quicksort(a, QSDNA{}, m); return; }
+  const size_t segments = (size_t)std::clamp(dna.segments, 16, 4096);
+  const size_t F = (size_t)std::clamp(dna.fanout, 16, 4096);
+
+  // Train on a random sample of samplePermille / 1000 of the input (at least
+  // a few samples per segment).
+  const size_t S = std::min(n, std::max(n * (size_t)std::clamp(dna.samplePermille, 1, 100) / 1000, 4 * segments));
+  std::vector<double> keys(S);
+  XRand rng(n * 0x9E3779B97F4A7C15ull);
+  for (auto& k : keys) k = model_key(a[rng.uniform(0, n-1)]);
+  quicksort(std::span<double>(keys), QSDNA{}, m);
+  CdfModel cdf;
+  if (!cdf.fit(keys, segments)) { quicksort(a, QSDNA{}, m); return; }
+
+  ScratchLease buf(n * sizeof(T)), ora(n * sizeof(uint16_t));
+  std::span<T> tmp = buf.as<T>(n);
+  uint16_t* oracle = ora.as<uint16_t>(n).data();
+  const double fF = double(F);
+
+  // Pass 1: scatter into F buckets by predicted position.
+  std::vector<size_t> start(F + 1, 0);
+  for (size_t i=0; i<n; ++i) {
+    const size_t b = std::min(F - 1, size_t(cdf(model_key(a[i])) * fF));
+    oracle[i] = uint16_t(b);
+    ++start[b];
+  }
+  size_t maxLen = 0, sum = 0;
+  for (size_t b=0; b<F; ++b) { maxLen = std::max(maxLen, start[b]); size_t c = start[b]; start[b] = sum; sum += c; }
+  start[F] = n;
+  {
+    std::vector<size_t> pos(start.begin(), start.end() - 1);
+    for (size_t i=0; i<n; ++i) { tmp[pos[oracle[i]]++] = a[i]; ++m.swaps; }
+  }
+  note_aux(m, n * (sizeof(T) + sizeof(uint16_t)) + 2 * (maxLen + 1) * sizeof(uint32_t));
+
+  // Pass 2: inside each bucket, counting-sort back into a by the predicted
+  // slot, then fix up runs of elements that share a slot.
+  std::vector<uint32_t> slot(maxLen), cnt(maxLen + 1);
+  for (size_t b=0; b<F; ++b) {
+    const size_t lo = start[b], len = start[b+1] - lo;
+    if (len == 0) continue;
+    if (len == 1) { a[lo] = tmp[lo]; ++m.swaps; continue; }
+    const double fl = double(len);
+    std::fill(cnt.begin(), cnt.begin() + len + 1, 0u);
+    for (size_t j=0; j<len; ++j) {
+      const double f = cdf(model_key(tmp[lo+j])) * fF - double(b);
+      const uint32_t s = uint32_t(std::min(len - 1, size_t(f > 0 ? f * fl : 0.0)));
+      slot[j] = s;
+      ++cnt[s + 1];
+    }
+    for (size_t s=0; s<len; ++s) cnt[s+1] += cnt[s];
+    for (size_t j=0; j<len; ++j) { a[lo + cnt[slot[j]]++] = tmp[lo+j]; ++m.swaps; }
+    // cnt[s] is now the end of slot s, and the start of slot s+1.
+    size_t g0 = 0;
+    for (size_t s=0; s<len && g0<len; ++s) {
+      const size_t g1 = cnt[s];
+      if (g1 - g0 > 1) {
+        std::span<T> g = a.subspan(lo + g0, g1 - g0);
+        if (g.size() <= kFixupInsertionMax) small_sort(g, SmallSort::Insertion, m);
+        else quicksort(g, QSDNA{}, m);
+      }
+      g0 = std::max(g0, g1);
+    }
+  }
+}
+
+#define LEARNED_INSTANTIATE(T) \
+  template void learned_sort<T, Metrics>(std::span<T>, const LearnedDNA&, Metrics&); \
+  template void learned_sort<T, NullMetrics>(std::span<T>, const LearnedDNA&, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(LEARNED_INSTANTIATE)
@@ -1,43 +1,201 @@
 #include "logging.hpp"
 #include <iomanip>
+#include <variant>
 
 void write_csv_header(std::ostream& os) {
   os << "run_id,step,algo,opt,"
-     << "pivot,scheme,cutoff,depth,tail,"
-     << "run_threshold,iterative,reuse_buffer,"
-     << "fitness_ms,comparisons,swaps,"
-     << "n,trials_per_dist,dist_mask,pop_idx,temp\n";
+     << "pivot,scheme,cutoff,depth,tail,pivots,fallback,eq_left,presort,shuffle,"
+     << "run_threshold,iterative,reuse_buffer,buffer,merge_kernel,natural,min_run,min_gallop,merge_arity,in_place,in_place_buffer,"
+     << "digit_bits,radix_order,radix_in_place,radix_fallback,prefetch,"
+     << "buckets,oversample,base_case,base_threshold,"
+     << "sample_permille,segments,fanout,"
+     << "threads,grain,small_sort,counting_threshold,"
+     << "fitness_ms,comparisons,swaps,aux_bytes,"
+     << "n,trials_per_dist,dist_mask,elem,pop_idx,temp\n";
+}
+static const char* algo_name(Algo a) {
+  switch(a){case Algo::QS:return "QS";case Algo::MS:return "MS";case Algo::Radix:return "Radix";case Algo::Sample:return "Sample";default:return "Learned";}
 }
-static const char* algo_name(Algo a) { return a==Algo::QS ? "QS" : "MS"; }
 static const char* opt_name(Opt o) { return o==Opt::GA ? "GA" : "SA"; }
 static const char* pivot_name(Pivot p) {
-  switch(p){case Pivot::First:return "First";case Pivot::Last:return "Last";default:return "Median3";}
+  switch(p){
+    case Pivot::First:return "First";case Pivot::Last:return "Last";
+    case Pivot::Ninther:return "Ninther";case Pivot::Median5:return "Median5";case Pivot::Sampled:return "Sampled";
+    default:return "Median3";
+  }
 }
 static const char* scheme_name(PartitionScheme s) {
-  return s==PartitionScheme::Lomuto ? "Lomuto" : "Hoare";
+  switch(s){
+    case PartitionScheme::Lomuto:return "Lomuto";case PartitionScheme::Block:return "Block";
+    case PartitionScheme::ThreeWay:return "ThreeWay";case PartitionScheme::Simd:return "Simd";
+    default:return "Hoare";
+  }
+}
+static const char* fallback_name(DepthFallback f) {
+  switch(f){case DepthFallback::InsertionSort:return "Insertion";case DepthFallback::MergeSort:return "MergeSort";default:return "HeapSort";}
+}
+static const char* small_sort_name(SmallSort s) {
+  switch(s){
+    case SmallSort::Unguarded:return "Unguarded";case SmallSort::Binary:return "Binary";
+    case SmallSort::Network:return "Network";default:return "Insertion";
+  }
+}
+static const char* merge_kernel_name(MergeKernel k) {
+  switch(k){case MergeKernel::Branchless:return "Branchless";case MergeKernel::Simd:return "Simd";default:return "Branchy";}
+}
+static const char* sample_base_name(SampleBase b) {
+  switch(b){case SampleBase::MergeSort:return "MergeSort";case SampleBase::Radix:return "Radix";default:return "QuickSort";}
 }
 void write_csv_row(std::ostream& os,
                    const std::string& run_id, int step,
-                   Algo algo, Opt opt,
-                   const QSDNA* qs, const MSDNA* ms,
+                   Opt opt, const AnyDNA& dna,
                    const EvalResult& r,
                    std::size_t n, int trials_per_dist,
-                   unsigned dist_mask, int pop_idx, double temp) {
-  os << run_id << "," << step << "," << algo_name(algo) << "," << opt_name(opt) << ",";
+                   unsigned dist_mask, Elem elem, int pop_idx, double temp) {
+  const QSDNA* qs = std::get_if<QSDNA>(&dna);
+  const MSDNA* ms = std::get_if<MSDNA>(&dna);
+  const RadixDNA* rx = std::get_if<RadixDNA>(&dna);
+  const SampleDNA* ss = std::get_if<SampleDNA>(&dna);
+  const LearnedDNA* ls = std::get_if<LearnedDNA>(&dna);
+  os << run_id << "," << step << "," << algo_name(Algo(dna.index())) << "," << opt_name(opt) << ",";
   if (qs) {
     os << pivot_name(qs->pivot) << "," << scheme_name(qs->scheme) << ","
        << qs->insertionCutoff << "," << qs->depthCap << ","
-       << (qs->tailRecElim?1:0) << ",";
+       << (qs->tailRecElim?1:0) << "," << qs->pivotCount << ","
+       << fallback_name(qs->depthFallback) << "," << (qs->equalLeft?1:0) << ","
+       << (qs->presortCheck?1:0) << "," << (qs->patternShuffle?1:0) << ",";
   } else {
-    os << ",,,,,"; // blank quicksort fields
+    os << ",,,,,,,,,,"; // blank quicksort fields
   }
   if (ms) {
-    os << ms->runThreshold << "," << (ms->iterative?1:0) << "," << (ms->reuseBuffer?1:0) << ",";
+    os << ms->runThreshold << "," << (ms->iterative?1:0) << "," << (ms->reuseBuffer?1:0) << ","
+       << (ms->buffer == MergeBuffer::PerLevel ? "PerLevel" : "Arena") << ","
+       << merge_kernel_name(ms->mergeKernel) << ","
+       << (ms->natural?1:0) << "," << ms->minRun << "," << ms->minGallop << ","
+       << ms->mergeArity << "," << (ms->inPlace?1:0) << "," << ms->inPlaceBuffer << ",";
+  } else {
+    os << ",,,,,,,,,,,"; // blank mergesort fields
+  }
+  if (rx) {
+    os << rx->digitBits << "," << (rx->order == RadixOrder::LSD ? "LSD" : "MSD") << ","
+       << (rx->inPlace?1:0) << "," << rx->fallbackThreshold << "," << (rx->prefetch?1:0) << ",";
+  } else {
+    os << ",,,,,"; // blank radix fields
+  }
+  if (ss) {
+    os << ss->buckets << "," << ss->oversample << "," << sample_base_name(ss->baseCase) << "," << ss->baseThreshold << ",";
   } else {
-    os << ",,,"; // blank mergesort fields
+    os << ",,,,"; // blank samplesort fields
   }
+  if (ls) {
+    os << ls->samplePermille << "," << ls->segments << "," << ls->fanout << ",";
+  } else {
+    os << ",,,"; // blank learned-sort fields
+  }
+  // genes both algorithms have
+  if (qs)      os << qs->threads << "," << qs->parallelGrain << "," << small_sort_name(qs->smallSortKind) << "," << qs->countingThreshold << ",";
+  else if (ms) os << ms->threads << "," << ms->parallelGrain << "," << small_sort_name(ms->smallSortKind) << "," << ms->countingThreshold << ",";
+  else if (ss) os << ss->threads << "," << ss->parallelGrain << ",,,";
+  else         os << ",,,,";
   os << std::fixed << std::setprecision(6) << r.fitness_ms << ","
-     << r.comparisons << "," << r.swaps << ","
-     << n << "," << trials_per_dist << "," << dist_mask << ","
+     << r.comparisons << "," << r.swaps << "," << r.aux_bytes << ","
+     << n << "," << trials_per_dist << "," << dist_mask << "," << elem_name(elem) << ","
      << pop_idx << "," << temp << "\n";
 }
+
+// Designated initializers for the generated header, fields in declaration
+// order; enum values spelled as their enumerators.
+static const char* bool_init(bool v) { return v ? "true" : "false"; }
+static void write_init(std::ostream& os, const QSDNA& d, const char* ind) {
+  const char* fallback = d.depthFallback == DepthFallback::InsertionSort ? "InsertionSort"
+                       : d.depthFallback == DepthFallback::MergeSort ? "MergeSort" : "HeapSort";
+  os << "QSDNA{\n"
+     << ind << "  .pivot = Pivot::" << pivot_name(d.pivot) << ",\n"
+     << ind << "  .scheme = PartitionScheme::" << scheme_name(d.scheme) << ",\n"
+     << ind << "  .insertionCutoff = " << d.insertionCutoff << ",\n"
+     << ind << "  .smallSortKind = SmallSort::" << small_sort_name(d.smallSortKind) << ",\n"
+     << ind << "  .depthCap = " << d.depthCap << ",\n"
+     << ind << "  .tailRecElim = " << bool_init(d.tailRecElim) << ",\n"
+     << ind << "  .pivotCount = " << d.pivotCount << ",\n"
+     << ind << "  .depthFallback = DepthFallback::" << fallback << ",\n"
+     << ind << "  .equalLeft = " << bool_init(d.equalLeft) << ",\n"
+     << ind << "  .presortCheck = " << bool_init(d.presortCheck) << ",\n"
+     << ind << "  .patternShuffle = " << bool_init(d.patternShuffle) << ",\n"
+     << ind << "  .threads = " << d.threads << ",\n"
+     << ind << "  .parallelGrain = " << d.parallelGrain << ",\n"
+     << ind << "  .countingThreshold = " << d.countingThreshold << ",\n"
+     << ind << "}";
+}
+static void write_init(std::ostream& os, const MSDNA& d, const char* ind) {
+  os << "MSDNA{\n"
+     << ind << "  .runThreshold = " << d.runThreshold << ",\n"
+     << ind << "  .iterative = " << bool_init(d.iterative) << ",\n"
+     << ind << "  .reuseBuffer = " << bool_init(d.reuseBuffer) << ",\n"
+     << ind << "  .buffer = MergeBuffer::" << (d.buffer == MergeBuffer::PerLevel ? "PerLevel" : "Arena") << ",\n"
+     << ind << "  .mergeKernel = MergeKernel::" << merge_kernel_name(d.mergeKernel) << ",\n"
+     << ind << "  .natural = " << bool_init(d.natural) << ",\n"
+     << ind << "  .minRun = " << d.minRun << ",\n"
+     << ind << "  .minGallop = " << d.minGallop << ",\n"
+     << ind << "  .mergeArity = " << d.mergeArity << ",\n"
+     << ind << "  .inPlace = " << bool_init(d.inPlace) << ",\n"
+     << ind << "  .inPlaceBuffer = " << d.inPlaceBuffer << ",\n"
+     << ind << "  .threads = " << d.threads << ",\n"
+     << ind << "  .parallelGrain = " << d.parallelGrain << ",\n"
+     << ind << "  .smallSortKind = SmallSort::" << small_sort_name(d.smallSortKind) << ",\n"
+     << ind << "  .countingThreshold = " << d.countingThreshold << ",\n"
+     << ind << "}";
+}
+static void write_init(std::ostream& os, const RadixDNA& d, const char* ind) {
+  os << "RadixDNA{\n"
+     << ind << "  .digitBits = " << d.digitBits << ",\n"
+     << ind << "  .order = RadixOrder::" << (d.order == RadixOrder::LSD ? "LSD" : "MSD") << ",\n"
+     << ind << "  .inPlace = " << bool_init(d.inPlace) << ",\n"
+     << ind << "  .fallbackThreshold = " << d.fallbackThreshold << ",\n"
+     << ind << "  .prefetch = " << bool_init(d.prefetch) << ",\n"
+     << ind << "}";
+}
+static void write_init(std::ostream& os, const SampleDNA& d, const char* ind) {
+  os << "SampleDNA{\n"
+     << ind << "  .buckets = " << d.buckets << ",\n"
+     << ind << "  .oversample = " << d.oversample << ",\n"
+     << ind << "  .baseCase = SampleBase::" << sample_base_name(d.baseCase) << ",\n"
+     << ind << "  .baseThreshold = " << d.baseThreshold << ",\n"
+     << ind << "  .threads = " << d.threads << ",\n"
+     << ind << "  .parallelGrain = " << d.parallelGrain << ",\n"
+     << ind << "}";
+}
+static void write_init(std::ostream& os, const LearnedDNA& d, const char* ind) {
+  os << "LearnedDNA{\n"
+     << ind << "  .samplePermille = " << d.samplePermille << ",\n"
+     << ind << "  .segments = " << d.segments << ",\n"
+     << ind << "  .fanout = " << d.fanout << ",\n"
+     << ind << "}";
+}
+
+void write_tuned_header(std::ostream& os, const std::string& run_id,
+                        const QSDNA* qs, const MSDNA* ms, const AutoTable* autoTable) {
+  os << "#pragma once\n"
+     << "// Generated by experiment --emit-header= from " << run_id << ".\n"
+     << "#include \"dna.hpp\"\n";
+  if (autoTable) os << "#include \"sort_auto.hpp\"\n";
+  os << "\n";
+  if (qs) { os << "inline constexpr QSDNA kTunedQS = "; write_init(os, *qs, ""); os << ";\n"; }
+  else    os << "inline constexpr QSDNA kTunedQS{}; // not evolved in this run\n";
+  if (ms) { os << "inline constexpr MSDNA kTunedMS = "; write_init(os, *ms, ""); os << ";\n"; }
+  else    os << "inline constexpr MSDNA kTunedMS{}; // not evolved in this run\n";
+  if (autoTable) {
+    // tuned_sort_auto() dispatches through kTunedAuto when this is defined
+    os << "\n#define ALGO_EVO_TUNED_AUTO 1\n"
+       << "inline constexpr AutoTable kTunedAuto{.bySize = {{\n";
+    for (int s = 0; s < kSizeClasses; ++s) {
+      os << "  // " << size_class_name((SizeClass)s) << "\n  {{\n";
+      for (int c = 0; c < kInputClasses; ++c) {
+        os << "    // " << input_class_name((InputClass)c) << "\n    AutoChoice{";
+        std::visit([&](const auto& d) { write_init(os, d, "    "); }, autoTable->bySize[s][c]);
+        os << "},\n";
+      }
+      os << "  }},\n";
+    }
+    os << "}}};\n";
+  }
+}
@@ -3,11 +3,15 @@
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <limits>
+#include <optional>
 #include "common.hpp"
 #include "logging.hpp"
 #include "evaluator.hpp"
 #include "ga.hpp"
 #include "sa.hpp"
+#include "sort_auto.hpp"
+#include "partition_simd.hpp"
 
 using namespace std;
 static EvalConfig parse_cfg(const vector<string>& args){
@@ -17,6 +21,13 @@ static EvalConfig parse_cfg(const vector<string>& args){
   if(auto v = argval(args, "--seeds")) cfg.masterSeed = stoull(*v);
   if(auto v = argval(args, "--jobs")) cfg.jobs = stoi(*v);
   if(hasflag(args, "--no-precompute")) cfg.precompute = false;
+  if(hasflag(args, "--no-count")) cfg.countOps = false;
+  if(auto v = argval(args, "--mem-weight")) cfg.memWeight = stod(*v);
+  if(auto v = argval(args, "--elem")){
+    auto e = parse_elem(*v);
+    if(!e){ cerr << "ERROR: unknown --elem=" << *v << " (use i32, i64, f32, f64 or record)\n"; exit(1); }
+    cfg.elem = *e;
+  }
   if(hasflag(args, "--use-kaggle")){
     cfg.useKaggle = true;
     cfg.kaggleCsvPath = argval(args, "--kaggle-path").value_or("data/logs/viral_data.csv");
@@ -90,7 +101,7 @@ int main(int argc, char** argv){
     cerr << "Running experiment: algo=" << algo << ", opt=" << opt 
          << ", pop=" << pop << ", gens=" << gens 
          << ", n=" << cfg.n << ", trials=" << cfg.trialsPerDist
-         << ", dists=" << cfg.dists.size();
+         << ", dists=" << cfg.dists.size() << ", elem=" << elem_name(cfg.elem);
     if(cfg.useKaggle) {
       cerr << ", dataset=Kaggle (" << cfg.kaggleCsvPath << ")";
     } else {
@@ -99,6 +110,7 @@ int main(int argc, char** argv){
     if(cfg.dists.size() == 1 && cfg.n >= 50000) {
       cerr << " [fast mode: single distribution for speed]";
     }
+    cerr << "\nSIMD partition kernel: " << simd_level_name(simd_level());
     cerr << "\nOutput: " << out << "\n";
     if(!verbose) {
       cerr << "(Add --verbose for detailed progress, --silent for no output, --full-test for all distributions)\n";
@@ -123,65 +135,95 @@ int main(int argc, char** argv){
   string run_id = "run" + to_string(now_ns());
 
   // checks what to run based on input changes ex. evaluater optimizers
-  bool run_qs = (algo == "qs" || algo == "both");
-  bool run_ms = (algo == "ms" || algo == "both");
+  bool run_qs = (algo == "qs" || algo == "both" || algo == "all");
+  bool run_ms = (algo == "ms" || algo == "both" || algo == "all");
+  bool run_radix = (algo == "radix" || algo == "all");
+  bool run_sample = (algo == "sample" || algo == "all");
+  bool run_learned = (algo == "learned" || algo == "all");
   bool use_ga = (opt == "ga" || opt == "both");
   bool use_sa = (opt == "sa" || opt == "both");
-  if(run_qs){
-    auto eval = [&](const QSDNA& d){ return eval_qs(d, cfg); };
+  // fastest quicksort / mergesort DNA of the run, for --emit-header=
+  optional<QSDNA> bestQS; optional<MSDNA> bestMS;
+  // GA and/or SA for one algorithm family, every evaluation logged as a CSV
+  // row; best, when given, receives the fastest DNA seen
+  auto run_family = [&]<class D>(const char* name, EvalResult (*evalOne)(const D&, const EvalConfig&),
+                                 optional<D>* best = nullptr){
+    auto eval = [&](const D& d){ return evalOne(d, cfg); };
+    double bestMs = numeric_limits<double>::infinity();
+    auto record = [&](Opt o, int step, int pop_idx, const D& dna, const EvalResult& r, double temp){
+      if(best && r.fitness_ms < bestMs){ bestMs = r.fitness_ms; *best = dna; }
+      write_csv_row(ofs, run_id, step, o, dna, r, cfg.n, cfg.trialsPerDist, dmask, cfg.elem, pop_idx, temp);
+    };
     if(use_ga){
-      if(!silent) cerr << "Running QuickSort + GA...\n";
+      if(!silent) cerr << "Running " << name << " + GA...\n";
       vector<vector<double>> hist;
-      auto logger = [&](int step, int pop_idx, const QSDNA& dna, const EvalResult& r, double){
-        write_csv_row(ofs, run_id, step, Algo::QS, Opt::GA, &dna, nullptr, r,
-                      cfg.n, cfg.trialsPerDist, dmask, pop_idx, 0.0);
-        if(pop_idx % 10 == 0 || pop_idx == 0) ofs.flush(); // flush periodically
+      auto logger = [&](int step, int pop_idx, const D& dna, const EvalResult& r, double){
+        record(Opt::GA, step, pop_idx, dna, r, 0.0);
+        if(pop_idx % 10 == 0) ofs.flush(); // flush periodically
         if(!silent && pop_idx == 0) cerr << "  Gen " << step << "/" << gens << " (fitness: " << r.fitness_ms << " ms)\n";
         if(verbose && pop_idx % 10 == 0) cerr << "    Pop[" << pop_idx << "] fitness: " << r.fitness_ms << " ms\n";
       };
-      run_ga<QSDNA>(eval, pop, gens, cfg.masterSeed, &hist, logger);
-      if(!silent) cerr << "QuickSort + GA completed.\n";
+      run_ga<D>(eval, pop, gens, cfg.masterSeed, &hist, logger);
+      if(!silent) cerr << name << " + GA completed.\n";
     }
     if(use_sa){
-      if(!silent) cerr << "Running QuickSort + SA...\n";
+      if(!silent) cerr << "Running " << name << " + SA...\n";
       vector<double> hist;
-      auto logger = [&](int step, int, const QSDNA& dna, const EvalResult& r, double temp){
-        write_csv_row(ofs, run_id, step, Algo::QS, Opt::SA, &dna, nullptr, r,
-                      cfg.n, cfg.trialsPerDist, dmask, -1, temp);
+      auto logger = [&](int step, int, const D& dna, const EvalResult& r, double temp){
+        record(Opt::SA, step, -1, dna, r, temp);
         if(!silent && (step % 5 == 0 || step == 0)) cerr << "  Step " << step << "/" << steps << " (fitness: " << r.fitness_ms << " ms)\n";
         if(verbose && step % 2 == 0) cerr << "    Step " << step << " fitness: " << r.fitness_ms << " ms, temp: " << temp << "\n";
       };
-      run_sa<QSDNA>(eval, steps, 1.0, 1e-3, cfg.masterSeed, &hist, logger);
-      if(!silent) cerr << "QuickSort + SA completed.\n";
-    }
-  }
-  if(run_ms){
-    auto eval = [&](const MSDNA& d){ return eval_ms(d, cfg); };
-    if(use_ga){
-      if(!silent) cerr << "Running MergeSort + GA...\n";
-      vector<vector<double>> hist;
-      auto logger = [&](int step, int pop_idx, const MSDNA& dna, const EvalResult& r, double){
-        write_csv_row(ofs, run_id, step, Algo::MS, Opt::GA, nullptr, &dna, r,
-                      cfg.n, cfg.trialsPerDist, dmask, pop_idx, 0.0);
-        if(pop_idx % 10 == 0 || pop_idx == 0) ofs.flush();
-        if(!silent && pop_idx == 0) cerr << "  Gen " << step << "/" << gens << " (fitness: " << r.fitness_ms << " ms)\n";
-        if(verbose && pop_idx % 10 == 0) cerr << "    Pop[" << pop_idx << "] fitness: " << r.fitness_ms << " ms\n";
-      };
-      run_ga<MSDNA>(eval, pop, gens, cfg.masterSeed, &hist, logger);
-      if(!silent) cerr << "MergeSort + GA completed.\n";
+      run_sa<D>(eval, steps, 1.0, 1e-3, cfg.masterSeed, &hist, logger);
+      if(!silent) cerr << name << " + SA completed.\n";
     }
-    if(use_sa){
-      if(!silent) cerr << "Running MergeSort + SA...\n";
-      vector<double> hist;
-      auto logger = [&](int step, int, const MSDNA& dna, const EvalResult& r, double temp){
-        write_csv_row(ofs, run_id, step, Algo::MS, Opt::SA, nullptr, &dna, r,
-                      cfg.n, cfg.trialsPerDist, dmask, -1, temp);
-        if(!silent && (step % 5 == 0 || step == 0)) cerr << "  Step " << step << "/" << steps << " (fitness: " << r.fitness_ms << " ms)\n";
-        if(verbose && step % 2 == 0) cerr << "    Step " << step << " fitness: " << r.fitness_ms << " ms, temp: " << temp << "\n";
-      };
-      run_sa<MSDNA>(eval, steps, 1.0, 1e-3, cfg.masterSeed, &hist, logger);
-      if(!silent) cerr << "MergeSort + SA completed.\n";
+  };
+  if(run_qs) run_family("QuickSort", eval_qs, &bestQS);
+  if(run_ms) run_family("MergeSort", eval_ms, &bestMS);
+  if(run_radix) run_family("RadixSort", eval_radix);
+  if(run_sample) run_family("SampleSort", eval_sample);
+  if(run_learned) run_family("LearnedSort", eval_learned);
+  optional<AutoTable> trainedAuto; // --algo=auto, for --emit-header=
+  if(algo == "auto"){
+    static const char* kFamily[] = {"QS", "MS", "Radix", "Sample", "Learned"}; // AutoChoice order
+    auto logger = [&](InputClass c, const EvalConfig& ccfg, int step, int pop_idx, const AutoChoice& dna, const EvalResult& r){
+      write_csv_row(ofs, run_id, step, Opt::GA, dna, r,
+                    ccfg.n, ccfg.trialsPerDist, dist_mask_of(ccfg.dists), cfg.elem, pop_idx, 0.0);
+      if(verbose && step == 0 && pop_idx == 0)
+        cerr << "  Training " << size_class_name(size_class(ccfg.n)) << " (n=" << ccfg.n << ") "
+             << input_class_name(c) << " / " << kFamily[dna.index()] << "...\n";
+    };
+    if(!silent) cerr << "Training the sort_auto table (" << kSizeClasses << " sizes x " << kInputClasses
+                     << " input classes x 5 families)...\n";
+    AutoTimes best{};
+    AutoTable table = train_auto_table(cfg, pop, gens, logger, &best);
+    ofs.flush();
+    if(!silent)
+      for(int s = 0; s < kSizeClasses; ++s)
+        for(int c = 0; c < kInputClasses; ++c)
+          cerr << "  " << size_class_name((SizeClass)s) << " (n=" << train_n_for((SizeClass)s, cfg.n) << ") "
+               << input_class_name((InputClass)c) << " -> " << kFamily[table.bySize[s][c].index()]
+               << " (" << best[s][c] << " ms)\n";
+    // The dispatcher against each class winner of cfg.n's size bucket run on every input.
+    if(!silent){
+      const int s = (int)size_class(cfg.n);
+      cerr << "sort_auto on all distributions: " << eval_auto(table, cfg).fitness_ms << " ms\n";
+      for(int c = 0; c < kInputClasses; ++c){
+        AutoTable single;
+        for(auto& row : single.bySize) row.fill(table.bySize[s][c]);
+        cerr << "  " << input_class_name((InputClass)c) << " winner alone: " << eval_auto(single, cfg).fitness_ms << " ms\n";
+      }
     }
+    trainedAuto = table;
+  }
+  if(auto path = argval(args, "--emit-header")){
+    std::filesystem::path hp(*path);
+    if(hp.has_parent_path()) std::filesystem::create_directories(hp.parent_path());
+    ofstream hdr(hp);
+    if(!hdr){ cerr << "ERROR: could not open " << *path << "\n"; return 1; }
+    write_tuned_header(hdr, run_id, bestQS ? &*bestQS : nullptr, bestMS ? &*bestMS : nullptr,
+                       trainedAuto ? &*trainedAuto : nullptr);
+    if(!silent) cerr << "Tuned DNA header written to: " << *path << " (rebuild tuned_sort to use it)\n";
   }
   if(!silent) cerr << "Experiment completed! Results written to: " << out << "\n";
   return 0;
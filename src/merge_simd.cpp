@@ -0,0 +1,75 @@
+#include "merge_simd.hpp"
+#include "partition_simd.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ALGO_EVO_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// scalar reference: conditional index advance instead of a branch per element
+static void merge_scalar(const int* x, std::size_t nx, const int* y, std::size_t ny, int* out) {
+  std::size_t i = 0, j = 0;
+  while (i < nx && j < ny) {
+    int a = x[i], b = y[j];
+    bool takeY = b < a;
+    *out++ = takeY ? b : a;
+    j += takeY; i += !takeY;
+  }
+  while (i < nx) *out++ = x[i++];
+  while (j < ny) *out++ = y[j++];
+}
+
+#ifdef ALGO_EVO_X86_SIMD
+// Sorts a bitonic 8-lane vector: half-cleaners at distance 4, 2, 1.
+__attribute__((target("avx2")))
+static inline __m256i bitonic_clean8(__m256i v) {
+  __m256i p = _mm256_permute2x128_si256(v, v, 0x01);
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1,0,3,2));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2,3,0,1));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+  return v;
+}
+
+// Inoue-style vector merge: a sorted 8-element carry is merged with the next
+// block from whichever run has the smaller head; the low half is final and
+// stored, the high half becomes the new carry. When the run to load from has
+// fewer than 8 left, the carry and that short rest are merged in scalar code,
+// then the result with the other run.
+__attribute__((target("avx2")))
+static void merge_avx2(const int* x, std::size_t nx, const int* y, std::size_t ny, int* out) {
+  if (nx < 8 || ny < 8) { merge_scalar(x, nx, y, ny, out); return; }
+  const __m256i rev = _mm256_setr_epi32(7,6,5,4,3,2,1,0);
+  __m256i carry = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x));
+  __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y));
+  std::size_t i = 8, j = 8;
+  while (true) {
+    b = _mm256_permutevar8x32_epi32(b, rev);
+    __m256i lo = bitonic_clean8(_mm256_min_epi32(carry, b));
+    carry = bitonic_clean8(_mm256_max_epi32(carry, b));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lo);
+    out += 8;
+    bool takeX = (j == ny) || (i < nx && x[i] <= y[j]);
+    if (takeX) { if (i + 8 > nx) break; b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)); i += 8; }
+    else       { if (j + 8 > ny) break; b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + j)); j += 8; }
+  }
+  alignas(32) int c[8];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(c), carry);
+  int t[15];
+  if (nx - i < 8) {
+    merge_scalar(c, 8, x + i, nx - i, t);
+    merge_scalar(t, 8 + (nx - i), y + j, ny - j, out);
+  } else {
+    merge_scalar(c, 8, y + j, ny - j, t);
+    merge_scalar(t, 8 + (ny - j), x + i, nx - i, out);
+  }
+}
+#endif
+
+void simd_merge_int(const int* x, std::size_t nx, const int* y, std::size_t ny, int* out) {
+#ifdef ALGO_EVO_X86_SIMD
+  if (simd_level() != SimdLevel::Scalar) { merge_avx2(x, nx, y, ny, out); return; }
+#endif
+  merge_scalar(x, nx, y, ny, out);
+}
@@ -1,74 +1,555 @@
 #include "mergesort.hpp"
+#include "counting.hpp"
+#include "small_sort.hpp"
+#include "elem.hpp"
+#include "scratch.hpp"
+#include "task_pool.hpp"
+#include "merge_simd.hpp"
 #include <algorithm>
+#include <array>
 #include <cassert>
-static inline bool less_cmp(int a, int b, Metrics& m) { ++m.comparisons; return a < b; }
-static inline void move_do(int& dst, int src, Metrics& m) { ++m.swaps; dst = src; }
-static void insertion_sort(std::span<int> a, Metrics& m) {
-  for (size_t i=1;i<a.size();++i) {
-    int key = a[i];
-    size_t j = i;
-    while (j>0 && less_cmp(key, a[j-1], m)) {
-      a[j] = a[j-1]; ++m.swaps; --j;
+#include <bit>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+template<class T, class M>
+static inline bool less_cmp(const T& a, const T& b, M& m) { ++m.comparisons; return a < b; }
+template<class T, class M>
+static inline void move_do(T& dst, const T& src, M& m) { ++m.swaps; dst = src; }
+// Stable merge of sorted x and y into out; ties go to x. The kernel changes
+// how, not what: Branchless advances indices with conditional moves instead of
+// a mispredicted branch (same comparisons), Simd uses the vector kernel for
+// int in uninstrumented runs. Counting runs keep the branchy loop for Simd, as
+// the vector kernel has no per-element comparisons to count.
+template<class T, class M>
+static void merge_into(std::span<T> x, std::span<T> y, T* out, M& m, MergeKernel k) {
+  if constexpr (std::is_same_v<T, int> && std::is_same_v<M, NullMetrics>) {
+    if (k == MergeKernel::Simd) { simd_merge_int(x.data(), x.size(), y.data(), y.size(), out); return; }
+  }
+  size_t i=0, j=0;
+  if (k == MergeKernel::Branchless || (k == MergeKernel::Simd && !std::is_same_v<M, Metrics>)) {
+    while (i<x.size() && j<y.size()) {
+      bool takeY = less_cmp(y[j], x[i], m);
+      move_do(*out++, takeY ? y[j] : x[i], m);
+      j += takeY; i += !takeY;
+    }
+  } else {
+    while (i<x.size() && j<y.size()) {
+      if (!less_cmp(y[j], x[i], m)) move_do(*out++, x[i++], m);
+      else                          move_do(*out++, y[j++], m);
     }
-    a[j] = key;
   }
+  while (i<x.size()) move_do(*out++, x[i++], m);
+  while (j<y.size()) move_do(*out++, y[j++], m);
 }
-static void merge_run(std::span<int> a, std::span<int> b, size_t left, size_t mid, size_t right, Metrics& m) {
-  size_t i=left, j=mid, k=left;
-  while (i<mid && j<right) {
-    if (!less_cmp(b[j], b[i], m)) move_do(a[k++], b[i++], m);
-    else                          move_do(a[k++], b[j++], m);
+// merges the adjacent runs b[left,mid) and b[mid,right) into a[left,right)
+template<class T, class M>
+static void merge_run(std::span<T> a, std::span<T> b, size_t left, size_t mid, size_t right, M& m, MergeKernel k) {
+  merge_into(b.subspan(left, mid-left), b.subspan(mid, right-mid), a.data()+left, m, k);
+}
+// Scratch for one sort: leased from the shared pool with reuseBuffer, owned
+// by the call otherwise. Either way it counts towards the sort's auxBytes.
+template<class T>
+struct SortScratch {
+  std::optional<ScratchLease> lease;
+  std::vector<T> owned;
+  std::span<T> buf;
+  template<class M>
+  SortScratch(size_t n, bool reuse, M& m) {
+    if (reuse) { lease.emplace(n*sizeof(T)); buf = lease->template as<T>(n); }
+    else       { owned.resize(n); buf = std::span<T>(owned.data(), n); }
+    note_aux(m, n*sizeof(T));
+  }
+};
+// k-way merge of the runs src[left + r*width, ...) for r < k (clipped to n)
+// into dst through a loser tree: each output costs log2(k) comparisons against
+// the losers on one leaf-to-root path. Ties go to the lower run, so it is
+// stable. The tree only holds non-empty runs and is rebuilt over the survivors
+// whenever one runs dry, which keeps exhaustion checks out of the inner loop.
+template<class T, class M>
+static void merge_kway(std::span<T> dst, std::span<T> src, size_t left, size_t width, size_t k, M& m) {
+  constexpr size_t kMax = 16;
+  const size_t n = src.size();
+  std::array<size_t, kMax> cur{}, end{};
+  size_t live = 0; // runs still holding elements, in input order
+  for (size_t r=0; r<k; ++r) {
+    size_t b = std::min(n, left + r*width), e = std::min(n, b + width);
+    if (b < e) { cur[live] = b; end[live] = e; ++live; }
   }
-  while (i<mid) move_do(a[k++], b[i++], m);
-  while (j<right) move_do(a[k++], b[j++], m);
+  size_t out = left;
+  std::array<size_t, kMax> loser{};
+  std::array<size_t, 2*kMax> w{};
+  std::array<T, kMax> head{}; // current head of every live run, off the src indirection
+  while (live > 1) {
+    for (size_t r=0; r<live; ++r) head[r] = src[cur[r]];
+    // does run r's head come out before run s's? For r < s that is
+    // !(s < r), otherwise r < s: one comparison with swapped operands
+    auto wins = [&](size_t r, size_t s) {
+      const bool lower = r < s;
+      const T& x = head[lower ? s : r];
+      const T& y = head[lower ? r : s];
+      return less_cmp(x, y, m) != lower;
+    };
+    for (size_t r=0; r<live; ++r) w[live+r] = r;
+    for (size_t i=live-1; i>=1; --i) {
+      size_t a = w[2*i], b = w[2*i+1];
+      if (wins(a, b)) { w[i] = a; loser[i] = b; }
+      else            { w[i] = b; loser[i] = a; }
+    }
+    size_t winner = w[1];
+    while (true) {
+      move_do(dst[out++], head[winner], m);
+      if (++cur[winner] == end[winner]) break;
+      head[winner] = src[cur[winner]];
+      for (size_t node = (live + winner) / 2; node >= 1; node /= 2) {
+        // swap by mask: the outcome is a coin flip on random input, and a
+        // branch here mispredicts about half the time
+        const size_t l = loser[node];
+        const size_t flip = (l ^ winner) & (size_t(0) - size_t(wins(l, winner)));
+        loser[node] = l ^ flip;
+        winner ^= flip;
+      }
+    }
+    for (size_t r=winner; r+1<live; ++r) { cur[r] = cur[r+1]; end[r] = end[r+1]; }
+    --live;
+  }
+  if (live == 1) while (cur[0] < end[0]) move_do(dst[out++], src[cur[0]++], m);
 }
-void mergesort(std::span<int> a, const MSDNA& dna, Metrics& m) {
+// Sorting networks are not stable: mergesort runs SmallSort::Network as
+// binary insertion, the kernel networks fall back to above kSmallNetworkMax.
+static constexpr SmallSort stable_kind(SmallSort k) { return k == SmallSort::Network ? SmallSort::Binary : k; }
+// Top-down mergesort. With an arena, `tmp` is the part of it that lines up
+// with `a`; with MergeBuffer::PerLevel it is empty and every merge allocates.
+template<class T, class M, class D>
+static void ms_topdown(std::span<T> a, std::span<T> tmp, const D& dna, M& m) {
   size_t n = a.size();
   if (n<=1) return;
+  if (n <= (size_t)dna.runThreshold) { small_sort(a, stable_kind(dna.smallSortKind), m); return; }
+  size_t mid = n/2;
+  const bool arena = !tmp.empty();
+  ms_topdown(a.first(mid), arena ? tmp.first(mid) : tmp, dna, m);
+  ms_topdown(a.subspan(mid), arena ? tmp.subspan(mid) : tmp, dna, m);
+  std::vector<T> level;
+  if (arena) std::copy(a.begin(), a.end(), tmp.begin());
+  else {
+    // ancestors allocate only after this returns, so the largest level is the peak
+    level.assign(a.begin(), a.end());
+    tmp = std::span<T>(level.data(), n);
+    note_aux(m, n*sizeof(T));
+  }
+  merge_run(a, tmp, 0, mid, n, m, dna.mergeKernel);
+}
+// Merge path / co-ranking: how many of the first k outputs of a stable merge
+// of x and y come from x (ties go to x, like merge_run).
+template<class T, class M>
+static size_t co_rank(size_t k, std::span<T> x, std::span<T> y, M& m) {
+  size_t lo = k > y.size() ? k - y.size() : 0, hi = std::min(k, x.size());
+  while (lo < hi) {
+    size_t i = lo + (hi-lo)/2;
+    if (!less_cmp(y[k-i-1], x[i], m)) lo = i+1; // x[i] still precedes y[k-i-1]
+    else hi = i;
+  }
+  return lo;
+}
+template<class T, class M, class D>
+static void ms_serial(std::span<T> a, const D& dna, M& m);
 
-  if (!dna.iterative) {
-    // easy top-down with small-run insertion
-    if (n <= (size_t)dna.runThreshold) { insertion_sort(a, m); return; }
-    size_t mid = n/2;
-    mergesort(a.first(mid), dna, m);
-    mergesort(a.subspan(mid), dna, m);
-    std::vector<int> tmp(a.begin(), a.end());
-    std::span<int> b(tmp.data(), tmp.size());
-    merge_run(a, b, 0, mid, n, m);
-    return;
+// Parallel mode: chunks are sorted as tasks with the serial genes, then every
+// merge level ping-pongs through the scratch buffer with each pair of runs cut
+// into equal-output pieces by co-ranking, so a level spreads over all threads
+// even when only one or two merges are left.
+template<class T, class M, class D>
+static void mergesort_parallel(std::span<T> a, const D& dna, M& m) {
+  const size_t n = a.size();
+  const unsigned nt = (unsigned)dna.threads;
+  const size_t grain = (size_t)std::max(1, dna.parallelGrain);
+  TaskPool& pool = shared_task_pool();
+  const size_t limit = task_limit(nt); // at most nt cores, counting this thread
+  std::mutex mtx;
+  auto merge_metrics = [&](const M& lm) {
+    std::lock_guard<std::mutex> lk(mtx);
+    m.comparisons += lm.comparisons;
+    m.swaps += lm.swaps;
+    m.auxBytes += lm.auxBytes; // summed: chunk sorts may hold scratch at the same time
+  };
+  // power of two, also after the grain cap, so the levels pair up evenly
+  size_t chunks = std::bit_floor(std::min<size_t>(std::bit_ceil(nt), std::max<size_t>(1, n / grain)));
+  size_t width = (n + chunks - 1) / chunks;
+  {
+    TaskGroup g(pool, limit);
+    for (size_t lo=0; lo<n; lo+=width)
+      g.run([&, lo]{ M lm; ms_serial(a.subspan(lo, std::min(width, n-lo)), dna, lm); merge_metrics(lm); });
+    g.wait();
+  }
+  SortScratch<T> scratch(n, dna.reuseBuffer, m);
+  std::span<T> src = a, dst = scratch.buf;
+  const size_t piece = std::max(grain, (n + nt - 1) / nt);
+  for (; width < n; width *= 2) {
+    TaskGroup g(pool, limit);
+    for (size_t left=0; left<n; left += 2*width) {
+      const size_t mid = std::min(left+width, n), right = std::min(left+2*width, n), len = right-left;
+      const size_t pieces = (len + piece - 1) / piece;
+      for (size_t p=0; p<pieces; ++p) {
+        g.run([&, left, mid, right, len, pieces, p]{
+          M lm;
+          std::span<T> x = src.subspan(left, mid-left), y = src.subspan(mid, right-mid);
+          size_t k0 = len*p/pieces, k1 = len*(p+1)/pieces;
+          size_t i0 = co_rank(k0, x, y, lm), i1 = co_rank(k1, x, y, lm);
+          merge_into(x.subspan(i0, i1-i0), y.subspan(k0-i0, (k1-i1)-(k0-i0)), dst.data()+left+k0, lm, dna.mergeKernel);
+          merge_metrics(lm);
+        });
+      }
+    }
+    g.wait();
+    std::swap(src, dst);
+  }
+  if (src.data() != a.data()) {
+    TaskGroup g(pool, limit);
+    for (size_t lo=0; lo<n; lo+=piece)
+      g.run([&, lo]{
+        M lm;
+        for (size_t i=lo;i<std::min(n, lo+piece);++i) move_do(a[i], src[i], lm);
+        merge_metrics(lm);
+      });
+    g.wait();
   }
+}
+// ---- natural mode: run detection, Powersort merge policy, galloping ----
 
-  // bottom-up iterative mergesort with optional reusable buffer
-  std::vector<int> buf;
-  std::span<int> A = a;
-  std::span<int> B = A;
-  std::vector<int> storage;
-  if (dna.reuseBuffer) {
-    storage.assign(a.begin(), a.end());
-    B = std::span<int>(storage.data(), storage.size());
+// Exponential then binary search over x[0,n): Upper finds the first element
+// greater than key (upper bound), otherwise the first not less than key (lower
+// bound). Probing starts at the back when the answer is expected to be there.
+template<bool Upper, class T, class M>
+static size_t gallop(const T& key, const T* x, size_t n, bool fromBack, M& m) {
+  auto before = [&](size_t i) { return Upper ? !less_cmp(key, x[i], m) : less_cmp(x[i], key, m); };
+  size_t lo = 0, hi = n;
+  if (!fromBack) {
+    for (size_t p = 0, step = 1; p < n; p += step, step *= 2) {
+      if (!before(p)) { hi = p; break; }
+      lo = p+1;
+    }
+  } else {
+    for (size_t off = 1; off <= n; off *= 2) {
+      size_t p = n - off;
+      if (before(p)) { lo = p+1; break; }
+      hi = p;
+    }
+  }
+  while (lo < hi) {
+    size_t mid = lo + (hi-lo)/2;
+    if (before(mid)) lo = mid+1; else hi = mid;
+  }
+  return lo;
+}
+// State shared by the merges of one natural sort. minGallop adapts like in
+// Timsort: it drops while galloping pays off and rises when it does not.
+template<class T>
+struct NaturalState {
+  std::span<T> tmp;
+  size_t minGallop, gallopExit;
+};
+// Merges x (a copy of the left run) with the right run y, which sits in `out`
+// right after the x.size() slots being filled. Forward, ties go to x.
+template<class T, class M>
+static void merge_lo(std::span<T> x, T* y, size_t ny, T* out, NaturalState<T>& st, M& m) {
+  const size_t nx = x.size();
+  size_t i = 0, j = 0, k = 0;
+  while (i < nx && j < ny) {
+    size_t cx = 0, cy = 0;
+    while (i < nx && j < ny && cx < st.minGallop && cy < st.minGallop) {
+      if (less_cmp(y[j], x[i], m)) { move_do(out[k++], y[j++], m); ++cy; cx = 0; }
+      else                         { move_do(out[k++], x[i++], m); ++cx; cy = 0; }
+    }
+    if (i == nx || j == ny) break;
+    // one run keeps winning: copy whole stretches found by galloping
+    do {
+      if (st.minGallop > 1) --st.minGallop;
+      cx = gallop<true>(y[j], x.data()+i, nx-i, false, m);
+      for (size_t e = i+cx; i < e;) move_do(out[k++], x[i++], m);
+      if (i == nx) break;
+      move_do(out[k++], y[j++], m);
+      if (j == ny) break;
+      cy = gallop<false>(x[i], y+j, ny-j, false, m);
+      for (size_t e = j+cy; j < e;) move_do(out[k++], y[j++], m);
+      if (j == ny) break;
+      move_do(out[k++], x[i++], m);
+    } while (i < nx && (cx >= st.gallopExit || cy >= st.gallopExit));
+    ++st.minGallop;
+  }
+  while (i < nx) move_do(out[k++], x[i++], m); // the rest of y is already in place
+}
+// Mirror of merge_lo for a shorter right run: x is the left run in place at the
+// start of `out`, y a copy of the right run; fills from the back, ties go to x.
+template<class T, class M>
+static void merge_hi(T* x, size_t nx, std::span<T> y, T* out, NaturalState<T>& st, M& m) {
+  size_t i = nx, j = y.size(), k = nx + y.size();
+  while (i > 0 && j > 0) {
+    size_t cx = 0, cy = 0;
+    while (i > 0 && j > 0 && cx < st.minGallop && cy < st.minGallop) {
+      if (less_cmp(y[j-1], x[i-1], m)) { move_do(out[--k], x[--i], m); ++cx; cy = 0; }
+      else                             { move_do(out[--k], y[--j], m); ++cy; cx = 0; }
+    }
+    if (i == 0 || j == 0) break;
+    do {
+      if (st.minGallop > 1) --st.minGallop;
+      size_t p = gallop<true>(y[j-1], x, i, true, m);
+      cx = i - p;
+      while (i > p) move_do(out[--k], x[--i], m);
+      if (i == 0) break;
+      move_do(out[--k], y[--j], m);
+      if (j == 0) break;
+      size_t q = gallop<false>(x[i-1], y.data(), j, true, m);
+      cy = j - q;
+      while (j > q) move_do(out[--k], y[--j], m);
+      if (j == 0) break;
+      move_do(out[--k], x[--i], m);
+    } while (i > 0 && (cx >= st.gallopExit || cy >= st.gallopExit));
+    ++st.minGallop;
+  }
+  while (j > 0) move_do(out[--k], y[--j], m); // the rest of x is already in place
+}
+// Merges the adjacent runs a[lo,mid) and a[mid,hi). Elements already in their
+// final place at either end are skipped first, so concatenations that are
+// already in order cost two gallops; only the shorter remainder is copied out.
+template<class T, class M>
+static void merge_natural(std::span<T> a, size_t lo, size_t mid, size_t hi, NaturalState<T>& st, M& m) {
+  lo += gallop<true>(a[mid], a.data()+lo, mid-lo, false, m);
+  if (lo == mid) return;
+  hi = mid + gallop<false>(a[mid-1], a.data()+mid, hi-mid, true, m);
+  if (hi == mid) return;
+  if (mid-lo <= hi-mid) {
+    std::span<T> x = st.tmp.first(mid-lo);
+    for (size_t i=0;i<x.size();++i) move_do(x[i], a[lo+i], m);
+    merge_lo(x, a.data()+mid, hi-mid, a.data()+lo, st, m);
+  } else {
+    std::span<T> y = st.tmp.first(hi-mid);
+    for (size_t i=0;i<y.size();++i) move_do(y[i], a[mid+i], m);
+    merge_hi(a.data()+lo, mid-lo, y, a.data()+lo, st, m);
+  }
+}
+// Length of the run starting at lo; a strictly descending run is reversed in
+// place (strictness keeps equal elements in order).
+template<class T, class M>
+static size_t natural_run(std::span<T> a, size_t lo, M& m) {
+  size_t n = a.size(), hi = lo+1;
+  if (hi == n) return 1;
+  if (less_cmp(a[hi], a[lo], m)) {
+    while (hi+1 < n && less_cmp(a[hi+1], a[hi], m)) ++hi;
+    for (size_t l=lo, r=hi; l<r; ++l, --r) { std::swap(a[l], a[r]); ++m.swaps; }
   } else {
-    storage.resize(0); // reallocates per pass below
+    while (hi+1 < n && !less_cmp(a[hi+1], a[hi], m)) ++hi;
   }
+  return hi+1 - lo;
+}
+// Extends the sorted prefix a[lo,sorted) to a[lo,hi) by stable binary insertion.
+template<class T, class M>
+static void extend_run(std::span<T> a, size_t lo, size_t sorted, size_t hi, M& m) {
+  for (size_t i=sorted; i<hi; ++i) {
+    T v = a[i];
+    size_t p = lo + gallop<true>(v, a.data()+lo, i-lo, true, m);
+    for (size_t j=i; j>p; --j) move_do(a[j], a[j-1], m);
+    move_do(a[p], v, m);
+  }
+}
+// Powersort node power of the boundary between the runs [s1, s1+n1) and
+// [s1+n1, s1+n1+n2): the depth at which their midpoints, as fractions of n,
+// first fall into different halves.
+static unsigned node_power(size_t s1, size_t n1, size_t n2, size_t n) {
+  size_t x = 2*s1 + n1, y = x + n1 + n2; // twice the midpoints, in [0, 2n)
+  unsigned k = 0;
+  while (true) {
+    ++k;
+    bool bx = x >= n, by = y >= n;
+    if (bx != by) return k;
+    if (bx) { x -= n; y -= n; }
+    x *= 2; y *= 2;
+  }
+}
+// Natural mergesort: finds the runs already in the input (reversing descending
+// ones), pads short ones to minRun, and merges neighbours in Powersort order,
+// which keeps the merge tree near-optimal for the run lengths found.
+template<class T, class M, class D>
+static void ms_natural(std::span<T> a, const D& dna, M& m) {
+  const size_t n = a.size();
+  SortScratch<T> scratch(n/2 + 1, dna.reuseBuffer, m);
+  NaturalState<T> st{scratch.buf, (size_t)std::max(1, dna.minGallop), (size_t)std::max(1, dna.minGallop)};
+  const size_t minRun = (size_t)std::max(1, dna.minRun);
+  struct Run { size_t start, len; unsigned power; };
+  std::vector<Run> stack;
+  for (size_t lo = 0; lo < n;) {
+    size_t len = natural_run(a, lo, m);
+    if (len < minRun) {
+      size_t hi = std::min(n, lo + minRun);
+      extend_run(a, lo, lo+len, hi, m);
+      len = hi - lo;
+    }
+    unsigned p = 0;
+    if (!stack.empty()) {
+      p = node_power(stack.back().start, stack.back().len, len, n);
+      while (stack.size() >= 2 && stack.back().power > p) {
+        Run r = stack.back(); stack.pop_back();
+        Run& l = stack.back();
+        merge_natural(a, l.start, r.start, r.start + r.len, st, m);
+        l.len += r.len;
+      }
+    }
+    stack.push_back({lo, len, p});
+    lo += len;
+  }
+  while (stack.size() >= 2) {
+    Run r = stack.back(); stack.pop_back();
+    Run& l = stack.back();
+    merge_natural(a, l.start, r.start, r.start + r.len, st, m);
+    l.len += r.len;
+  }
+}
+// ---- in-place mode: rotation merges with an optional small fixed buffer ----
+
+// Rotates a[lo,hi) so that a[mid,hi) comes first, by three reversals.
+template<class T, class M>
+static void rotate_counted(std::span<T> a, size_t lo, size_t mid, size_t hi, M& m) {
+  auto rev = [&](size_t l, size_t r) { for (; l+1 < r; ++l, --r) { std::swap(a[l], a[r-1]); ++m.swaps; } };
+  rev(lo, mid); rev(mid, hi); rev(lo, hi);
+}
+// Stable merge of a[lo,mid) and a[mid,hi) without an n-sized buffer. Once the
+// shorter side fits the fixed buffer it is a normal galloping merge; above
+// that, split the longer run in half, binary-search the matching cut in the
+// other, rotate the two middle pieces past each other and solve both halves
+// (the smaller recursively, the larger in the loop, so the stack stays
+// O(log n)). That is the merge std::inplace_merge falls back to without memory.
+template<class T, class M>
+static void merge_inplace(std::span<T> a, size_t lo, size_t mid, size_t hi, NaturalState<T>& st, M& m) {
+  while (lo < mid && mid < hi) {
+    if (!less_cmp(a[mid], a[mid-1], m)) return; // already in order
+    if (std::min(mid-lo, hi-mid) <= st.tmp.size()) { merge_natural(a, lo, mid, hi, st, m); return; }
+    if (mid-lo == 1 && hi-mid == 1) { std::swap(a[lo], a[mid]); ++m.swaps; return; }
+    size_t c1, c2;
+    if (mid-lo >= hi-mid) {
+      c1 = lo + (mid-lo)/2;
+      c2 = mid + gallop<false>(a[c1], a.data()+mid, hi-mid, false, m); // right elements < a[c1]
+    } else {
+      c2 = mid + (hi-mid)/2;
+      c1 = lo + gallop<true>(a[c2], a.data()+lo, mid-lo, false, m);    // left elements <= a[c2]
+    }
+    rotate_counted(a, c1, mid, c2, m);
+    const size_t split = c1 + (c2-mid);
+    if (split-lo < hi-split) { merge_inplace(a, lo, c1, split, st, m); lo = split; mid = c2; }
+    else                     { merge_inplace(a, split, c2, hi, st, m); hi = split; mid = c1; }
+  }
+}
+// Bottom-up in-place mergesort: the runThreshold pre-pass, then rotation
+// merges of doubling width. Scratch is at most inPlaceBuffer elements.
+template<class T, class M, class D>
+static void ms_inplace(std::span<T> a, const D& dna, M& m) {
+  const size_t n = a.size();
+  const size_t bufLen = std::min(n/2, (size_t)std::max(0, dna.inPlaceBuffer));
+  std::optional<SortScratch<T>> scratch;
+  if (bufLen > 0) scratch.emplace(bufLen, dna.reuseBuffer, m);
+  NaturalState<T> st{scratch ? scratch->buf : std::span<T>{},
+                     (size_t)std::max(1, dna.minGallop), (size_t)std::max(1, dna.minGallop)};
+  const size_t run = std::max<size_t>(1, (size_t)dna.runThreshold);
+  if (run > 1)
+    for (size_t i=0;i<n;i+=run) small_sort(a.subspan(i, std::min(n, i+run)-i), stable_kind(dna.smallSortKind), m);
+  for (size_t width = run; width < n; width *= 2)
+    for (size_t lo=0; lo+width<n; lo += 2*width)
+      merge_inplace(a, lo, lo+width, std::min(n, lo+2*width), st, m);
+}
+// Natural, top-down or bottom-up mergesort of a; also the chunk sort of the
+// parallel mode. D is MSDNA, an MSKernel table entry, or MSFixed<V> for
+// mergesort_fixed.
+template<class T, class M, class D>
+static void ms_serial(std::span<T> a, const D& dna, M& m) {
+  size_t n = a.size();
+  if (n<=1) return;
+  if (dna.natural) { ms_natural(a, dna, m); return; }
+
+  if (!dna.iterative) {
+    // top-down with small-run base case
+    if (dna.buffer == MergeBuffer::PerLevel) { ms_topdown(a, std::span<T>{}, dna, m); return; }
+    SortScratch<T> scratch(n, dna.reuseBuffer, m);
+    ms_topdown(a, scratch.buf, dna, m);
+    return;
+  }
+
+  // bottom-up iterative mergesort: passes ping-pong between `a` and a scratch
+  // buffer, so every pass moves each element exactly once
+  SortScratch<T> scratch(n, dna.reuseBuffer, m);
+  std::span<T> src = a, dst = scratch.buf;
   // small-run insertion pre-pass implementation below 
   if (dna.runThreshold > 0) {
     for (size_t i=0;i<n;i += (size_t) dna.runThreshold) {
       size_t r = std::min(n, i + (size_t)dna.runThreshold);
-      insertion_sort(A.subspan(i, r-i), m);
+      small_sort(src.subspan(i, r-i), stable_kind(dna.smallSortKind), m);
     }
   }
 
-  for (size_t width = std::max<size_t>(1, (size_t)dna.runThreshold); width < n; width *= 2) {
-    if (!dna.reuseBuffer) {
-      storage.assign(A.begin(), A.end());
-      B = std::span<int>(storage.data(), storage.size());
-    }
-    // copy A toB
-    for (size_t i=0;i<n;++i) B[i] = A[i], ++m.swaps;
-    for (size_t i=0;i<n; i += 2*width) {
+  // mergeArity runs are merged per group, so there are log_k(n/runs) passes
+  const size_t k = std::clamp<size_t>(std::bit_ceil((size_t)std::max(2, dna.mergeArity)), 2, 16);
+  for (size_t width = std::max<size_t>(1, (size_t)dna.runThreshold); width < n; width *= k) {
+    for (size_t i=0;i<n; i += k*width) {
       size_t left = i;
       size_t mid  = std::min(i+width, n);
       size_t right= std::min(i+2*width, n);
-      merge_run(A, B, left, mid, right, m);
+      if (k == 2) merge_run(dst, src, left, mid, right, m, dna.mergeKernel);
+      else        merge_kway(dst, src, left, width, k, m);
     }
+    std::swap(src, dst);
   }
+  // an odd number of passes leaves the result in the scratch buffer
+  if (src.data() != a.data())
+    for (size_t i=0;i<n;++i) move_do(a[i], src[i], m);
 }
+template<class T, class M, class D>
+static void ms_entry(std::span<T> a, const D& dna, M& m) {
+  if (a.size()<=1) return;
+  if (dna.inPlace) { ms_inplace(a, dna, m); return; }
+  if (counting_sort_small_range(a, dna.countingThreshold, m)) return;
+  if (dna.threads > 1 && a.size() >= 2*(size_t)std::max(1, dna.parallelGrain)) { mergesort_parallel(a, dna, m); return; }
+  ms_serial(a, dna, m);
+}
+// Kernel table: one instantiation per (iterative, reuseBuffer, mergeKernel),
+// picked once per call, so the merge loops carry no kernel dispatch.
+constexpr size_t kMergeKernels = size_t(MergeKernel::Simd) + 1;
+template<class T, class M>
+using MSKernelFn = void (*)(std::span<T>, const MSDNA&, M&);
+template<class T, class M, size_t I>
+static void ms_kernel(std::span<T> a, const MSDNA& dna, M& m) {
+  constexpr MergeKernel k = MergeKernel(I % kMergeKernels);
+  ms_entry(a, MSKernel<(I / kMergeKernels % 2 != 0), (I / (2*kMergeKernels) != 0), k>(dna), m);
+}
+template<class T, class M, size_t... I>
+static constexpr std::array<MSKernelFn<T, M>, sizeof...(I)> ms_kernel_table(std::index_sequence<I...>) {
+  return {&ms_kernel<T, M, I>...};
+}
+template<class T, class M>
+void mergesort(std::span<T> a, const MSDNA& dna, M& m) {
+#ifdef ALGO_EVO_TUNED
+  ms_entry(a, dna, m); // the tuned library itself only runs mergesort_fixed
+#else
+  if constexpr (std::is_same_v<M, NullMetrics>) {
+    static constexpr auto table = ms_kernel_table<T, M>(std::make_index_sequence<kMergeKernels*4>{});
+    const size_t i = size_t(dna.mergeKernel) + kMergeKernels*(size_t(dna.iterative) + 2*size_t(dna.reuseBuffer));
+    assert(i < table.size());
+    table[i](a, dna, m);
+  } else {
+    ms_entry(a, dna, m); // counting runs are untimed, one generic kernel serves them
+  }
+#endif
+}
+template<MSDNA V, class T, class M>
+void mergesort_fixed(std::span<T> a, M& m) {
+  ms_entry(a, MSFixed<V>{}, m);
+}
+#define MS_INSTANTIATE(T) \
+  template void mergesort<T, Metrics>(std::span<T>, const MSDNA&, Metrics&); \
+  template void mergesort<T, NullMetrics>(std::span<T>, const MSDNA&, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(MS_INSTANTIATE)
+
+#ifdef ALGO_EVO_TUNED
+// tuned_sort library build: the kernels once more, on the generated DNA.
+#include "tuned_dna.hpp"
+#define MS_TUNED_INSTANTIATE(T) \
+  template void mergesort_fixed<kTunedMS, T, NullMetrics>(std::span<T>, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(MS_TUNED_INSTANTIATE)
+#endif
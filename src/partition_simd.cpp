@@ -0,0 +1,141 @@
+#include "partition_simd.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ALGO_EVO_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// scalar reference kernel, also used for the remainders of the vector kernels
+static std::size_t partition_scalar(int* a, std::size_t left, std::size_t right, int pivot) {
+  while (left < right) {
+    if (a[left] < pivot) ++left;
+    else std::swap(a[left], a[--right]);
+  }
+  return left;
+}
+
+#ifdef ALGO_EVO_X86_SIMD
+// Vector kernels (Bramas / Blacher style, in place): one vector is held back from
+// each end so there are always free slots to write into; each loaded vector is
+// split by a pivot compare, "< pivot" lanes are written at the left store
+// position and ">= pivot" lanes at the right one. Loads come from whichever side
+// has less free space, so stores never clobber unread data.
+
+// permutation table for AVX2: for a mask of ">= pivot" lanes, the "< pivot"
+// lanes come first (in order) followed by the rest
+struct PermTable { alignas(32) int32_t idx[256][8]; };
+static constexpr PermTable make_perm_table() {
+  PermTable t{};
+  for (int m=0;m<256;++m) {
+    int k = 0;
+    for (int i=0;i<8;++i) if (!((m>>i)&1)) t.idx[m][k++] = i;
+    for (int i=0;i<8;++i) if ( (m>>i)&1 ) t.idx[m][k++] = i;
+  }
+  return t;
+}
+static constexpr PermTable kPerm = make_perm_table();
+
+__attribute__((target("avx2,popcnt")))
+static inline void store_avx2(int* a, __m256i v, __m256i P, std::ptrdiff_t& ls, std::ptrdiff_t& rs) {
+  int ge = ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(P, v))) & 0xFF;
+  int nge = _mm_popcnt_u32(unsigned(ge));
+  __m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i*>(kPerm.idx[ge]));
+  __m256i w = _mm256_permutevar8x32_epi32(v, perm);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + ls), w);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + rs), w);
+  ls += 8 - nge; rs -= nge;
+}
+
+__attribute__((target("avx2,popcnt")))
+static std::size_t partition_avx2(int* a, std::size_t n, int pivot) {
+  using idx = std::ptrdiff_t;
+  idx left = 0, right = idx(n);
+  // peel until the middle is a whole number of vectors
+  for (idx r = idx(n % 8); r > 0; --r) {
+    if (a[left] < pivot) ++left;
+    else std::swap(a[left], a[--right]);
+  }
+  if (right - left < 16) return partition_scalar(a, size_t(left), size_t(right), pivot);
+
+  const __m256i P = _mm256_set1_epi32(pivot);
+  idx ls = left, rs = right - 8;
+  __m256i vl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + left));
+  __m256i vr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + right - 8));
+  left += 8; right -= 8;
+  while (left < right) {
+    __m256i v;
+    if ((rs + 8) - right < left - ls) { right -= 8; v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + right)); }
+    else { v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + left)); left += 8; }
+    store_avx2(a, v, P, ls, rs);
+  }
+  store_avx2(a, vl, P, ls, rs);
+  store_avx2(a, vr, P, ls, rs);
+  return size_t(ls);
+}
+
+__attribute__((target("avx512f,popcnt")))
+static inline void store_avx512(int* a, __m512i v, __m512i P, std::ptrdiff_t& ls, std::ptrdiff_t& rs) {
+  __mmask16 lt = _mm512_cmplt_epi32_mask(v, P);
+  int nlt = _mm_popcnt_u32(unsigned(lt));
+  _mm512_mask_compressstoreu_epi32(a + ls, lt, v);
+  _mm512_mask_compressstoreu_epi32(a + rs + nlt, __mmask16(~lt), v);
+  ls += nlt; rs -= 16 - nlt;
+}
+
+__attribute__((target("avx512f,popcnt")))
+static std::size_t partition_avx512(int* a, std::size_t n, int pivot) {
+  using idx = std::ptrdiff_t;
+  idx left = 0, right = idx(n);
+  for (idx r = idx(n % 16); r > 0; --r) {
+    if (a[left] < pivot) ++left;
+    else std::swap(a[left], a[--right]);
+  }
+  if (right - left < 32) return partition_scalar(a, size_t(left), size_t(right), pivot);
+
+  const __m512i P = _mm512_set1_epi32(pivot);
+  idx ls = left, rs = right - 16;
+  __m512i vl = _mm512_loadu_si512(a + left);
+  __m512i vr = _mm512_loadu_si512(a + right - 16);
+  left += 16; right -= 16;
+  while (left < right) {
+    __m512i v;
+    if ((rs + 16) - right < left - ls) { right -= 16; v = _mm512_loadu_si512(a + right); }
+    else { v = _mm512_loadu_si512(a + left); left += 16; }
+    store_avx512(a, v, P, ls, rs);
+  }
+  store_avx512(a, vl, P, ls, rs);
+  store_avx512(a, vr, P, ls, rs);
+  return size_t(ls);
+}
+#endif
+
+SimdLevel simd_level() {
+#ifdef ALGO_EVO_X86_SIMD
+  static const SimdLevel level = []{
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2"))    return SimdLevel::AVX2;
+    return SimdLevel::Scalar;
+  }();
+  return level;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+const char* simd_level_name(SimdLevel s) {
+  switch (s) { case SimdLevel::AVX512: return "AVX-512"; case SimdLevel::AVX2: return "AVX2"; default: return "scalar"; }
+}
+
+std::size_t simd_partition_less(int* a, std::size_t n, int pivot) {
+#ifdef ALGO_EVO_X86_SIMD
+  switch (simd_level()) {
+    case SimdLevel::AVX512: return partition_avx512(a, n, pivot);
+    case SimdLevel::AVX2:   return partition_avx2(a, n, pivot);
+    default: break;
+  }
+#endif
+  return partition_scalar(a, 0, n, pivot);
+}
@@ -1,14 +1,28 @@
 #include "quicksort.hpp"
+#include "mergesort.hpp"
+#include "counting.hpp"
+#include "partition_simd.hpp"
+#include "small_sort.hpp"
+#include "task_pool.hpp"
+#include "elem.hpp"
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <limits>
 #include <cassert>
 #include <cmath>
-static inline bool less_cmp(int a, int b, Metrics& m) { ++m.comparisons; return a < b; }
-static inline void swap_do(int& a, int& b, Metrics& m) { ++m.swaps; std::swap(a,b); }
-static void insertion_sort(std::span<int> a, Metrics& m) {
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+template<class T, class M>
+static inline bool less_cmp(const T& a, const T& b, M& m) { ++m.comparisons; return a < b; }
+template<class T, class M>
+static inline void swap_do(T& a, T& b, M& m) { ++m.swaps; std::swap(a,b); }
+template<class T, class M>
+static void insertion_sort(std::span<T> a, M& m) {
   for (size_t i=1;i<a.size();++i) {
-    int key = a[i];
+    T key = a[i];
     size_t j = i;
     while (j>0 && less_cmp(key, a[j-1], m)) {
       a[j] = a[j-1];
@@ -19,25 +33,98 @@ static void insertion_sort(std::span<int> a, Metrics& m) {
   }
 }
 
-static int pivot_choose(std::span<int> a, Pivot p, Metrics& m) {
-  if (p==Pivot::First) return a.front();
-  if (p==Pivot::Last)  return a.back();
-  // Median-of-3
-  size_t l=0, r=a.size()-1, mid=(l+r)/2;
-  int x=a[l], y=a[mid], z=a[r];
-  // compare counts
-  bool xy = less_cmp(x,y,m), yz = less_cmp(y,z,m), xz = less_cmp(x,z,m);
-  // simple median logic beloww
-  if ((xy && yz) || (!xy && !xz)) return y;
-  if ((xz && !yz) || (!xz && yz)) return z;
-  return x;
+// heapsort for the depth cap fallback (introsort), O(n log n) worst case
+template<class T, class M>
+static void sift_down(std::span<T> a, size_t i, size_t n, M& m) {
+  T v = a[i];
+  while (true) {
+    size_t c = 2*i+1;
+    if (c >= n) break;
+    if (c+1 < n && less_cmp(a[c], a[c+1], m)) ++c;
+    if (!less_cmp(v, a[c], m)) break;
+    a[i] = a[c]; ++m.swaps; // moves counted as swaps like insertion_sort
+    i = c;
+  }
+  a[i] = v;
+}
+template<class T, class M>
+static void heap_sort(std::span<T> a, M& m) {
+  size_t n = a.size();
+  if (n <= 1) return;
+  for (size_t i=n/2; i-- > 0;) sift_down(a, i, n, m);
+  for (size_t e=n-1; e>0; --e) { swap_do(a[0], a[e], m); sift_down(a, 0, e, m); }
+}
+template<class T, class M, class D>
+static void depth_fallback(std::span<T> a, const D& dna, M& m) {
+  switch (dna.depthFallback) {
+    case DepthFallback::HeapSort:  heap_sort(a, m); break;
+    case DepthFallback::MergeSort: mergesort(a, MSDNA{}, m); break; // bottom-up into a scratch buffer
+    default:                       insertion_sort(a, m); break;
+  }
+}
+
+// Pivot selection returns a position, so the partition can swap it into place
+// directly instead of searching the slice for the pivot value.
+template<class T, class M>
+static size_t median3_idx(std::span<T> a, size_t i, size_t j, size_t k, M& m) {
+  if (less_cmp(a[j], a[i], m)) std::swap(i, j);    // now a[i] <= a[j]
+  if (less_cmp(a[k], a[j], m)) j = less_cmp(a[k], a[i], m) ? i : k;
+  return j;
+}
+// Tukey's ninther: median of the medians of three evenly spread triples
+template<class T, class M>
+static size_t ninther_idx(std::span<T> a, M& m) {
+  size_t n = a.size(), s = n/8, mid = n/2;
+  size_t x = median3_idx(a, 0, s, 2*s, m);
+  size_t y = median3_idx(a, mid-s, mid, mid+s, m);
+  size_t z = median3_idx(a, n-1-2*s, n-1-s, n-1, m);
+  return median3_idx(a, x, y, z, m);
+}
+template<class T, class M>
+static size_t median5_idx(std::span<T> a, M& m) {
+  size_t n = a.size();
+  size_t e[5] = {0, n/4, n/2, (3*n)/4, n-1};
+  for (int i=1;i<5;++i)
+    for (int j=i; j>0 && less_cmp(a[e[j]], a[e[j-1]], m); --j) std::swap(e[j], e[j-1]);
+  return e[2];
+}
+// pseudo-median of ~sqrt(n) evenly spread samples: they are gathered at the
+// front of the slice and nth_element'd there, the median stays in the front block
+template<class T, class M>
+static size_t sampled_median_idx(std::span<T> a, M& m) {
+  size_t n = a.size();
+  size_t k = size_t(std::sqrt(double(n))) | 1, step = n / k;
+  for (size_t i=1;i<k;++i) swap_do(a[i], a[i*step], m);
+  std::nth_element(a.begin(), a.begin() + k/2, a.begin() + k,
+                   [&](const T& x, const T& y){ return less_cmp(x, y, m); });
+  return k/2;
+}
+template<class T, class M>
+static size_t pivot_index(std::span<T> a, Pivot p, M& m) {
+  size_t n = a.size();
+  switch (p) {
+    case Pivot::First:   return 0;
+    case Pivot::Last:    return n-1;
+    case Pivot::Ninther: if (n >= 9)  return ninther_idx(a, m); break;
+    case Pivot::Median5: if (n >= 5)  return median5_idx(a, m); break;
+    case Pivot::Sampled:
+      if (n >= 64) return sampled_median_idx(a, m);
+      if (n >= 9)  return ninther_idx(a, m);
+      break;
+    default: break;
+  }
+  return median3_idx(a, 0, (n-1)/2, n-1, m);
 }
 
+// Single-pivot partitions set `moved` when any element other than the pivot
+// changed place, which is the pdqsort "already partitioned" signal.
+
 // Lomuto partition below
-static size_t partition_lomuto(std::span<int> a, int pivot, Metrics& m) {
+template<class T, class M>
+static size_t partition_lomuto(std::span<T> a, T pivot, M& m, bool& moved) {
   size_t i=0;
   for (size_t j=0;j+1<a.size();++j) {
-    if (less_cmp(a[j], pivot, m)) { swap_do(a[i], a[j], m); ++i; }
+    if (less_cmp(a[j], pivot, m)) { moved |= (i != j); swap_do(a[i], a[j], m); ++i; }
   }
   // places the pivot at i by swapping with last one
   swap_do(a[i], a[a.size()-1], m);
@@ -45,60 +132,453 @@ static size_t partition_lomuto(std::span<int> a, int pivot, Metrics& m) {
 }
 
 // Hoare partition
-static size_t partition_hoare(std::span<int> a, int pivot, Metrics& m) {
+template<class T, class M>
+static size_t partition_hoare(std::span<T> a, T pivot, M& m, bool& moved) {
   size_t i=0, j=a.size()-1;
   while (true) {
     while (less_cmp(a[i], pivot, m)) ++i;
     while (less_cmp(pivot, a[j], m)) --j;
     if (i>=j) return j;
+    moved |= (i != 0); // the first swap only moves the front pivot into place
     swap_do(a[i], a[j], m);
     ++i; --j;
   }
 }
-static void qs_impl(std::span<int> a, const QSDNA& dna, Metrics& m, int depthLeft) {
-  if (a.size() <= 1) return;
-  if ((int)a.size() <= dna.insertionCutoff) { insertion_sort(a, m); return; }
-  if (depthLeft <= 0) { insertion_sort(a, m); return; } // simple cap fallback
-  // picks the pivot by moving chosen pivot to end for Lomuto 
-  int pv = pivot_choose(a, dna.pivot, m);
-  // place the pivot at end
+// Block partition (BlockQuicksort): scan fixed-size blocks from both ends,
+// record offsets of misplaced elements without branching, then swap in bulk.
+// Same contract as Lomuto: pivot sits at a.back(), returns its final index.
+static constexpr size_t kPartBlock = 64;
+template<class T, class M>
+static size_t partition_block(std::span<T> a, T pivot, M& m, bool& moved) {
+  unsigned char offL[kPartBlock], offR[kPartBlock];
+  size_t first = 0, last = a.size()-1; // [first,last) unpartitioned, pivot excluded
+  size_t numL = 0, numR = 0, startL = 0, startR = 0;
+  while (last - first > 2*kPartBlock) {
+    if (numL == 0) {
+      startL = 0;
+      for (size_t i=0;i<kPartBlock;++i) { offL[numL] = (unsigned char)i; numL += !less_cmp(a[first+i], pivot, m); }
+    }
+    if (numR == 0) {
+      startR = 0;
+      for (size_t i=0;i<kPartBlock;++i) { offR[numR] = (unsigned char)i; numR += !less_cmp(pivot, a[last-1-i], m); }
+    }
+    size_t num = std::min(numL, numR);
+    moved |= (num != 0);
+    for (size_t k=0;k<num;++k) swap_do(a[first + offL[startL+k]], a[last-1 - offR[startR+k]], m);
+    numL -= num; numR -= num; startL += num; startR += num;
+    if (numL == 0) first += kPartBlock;
+    if (numR == 0) last  -= kPartBlock;
+  }
+  // everything outside [first,last) is already on the right side; finish the tail
+  // with a symmetric scan so keys equal to the pivot still split both ways
+  size_t i = first, j = last;
+  while (true) {
+    while (i < j && less_cmp(a[i], pivot, m)) ++i;
+    while (i < j && less_cmp(pivot, a[j-1], m)) --j;
+    if (j - i <= 1) break;
+    moved = true;
+    swap_do(a[i], a[j-1], m);
+    ++i; --j;
+  }
+  swap_do(a[i], a[a.size()-1], m);
+  return i;
+}
+// Moves "< pivot" to the front of a[0,n) and returns the boundary: the vector
+// kernels for int, a scalar loop for the other element types.
+template<class T>
+static size_t partition_less(T* a, size_t n, const T& pivot) {
+  if constexpr (std::is_same_v<T, int>) {
+    return simd_partition_less(a, n, pivot);
+  } else {
+    size_t l = 0, r = n;
+    while (l < r) {
+      if (a[l] < pivot) ++l;
+      else std::swap(a[l], a[--r]);
+    }
+    return l;
+  }
+}
+// SIMD partition (AVX2/AVX-512 picked at runtime, see partition_simd.cpp).
+// Same contract as Lomuto. The vector kernel doesn't track moves, so it
+// reports `moved` conservatively; comparisons/swaps count one per element.
+// Only int has vector kernels; other element types use the Block partition.
+template<class T, class M>
+static size_t partition_simd(std::span<T> a, T pivot, M& m, bool& moved) {
+  if constexpr (std::is_same_v<T, int>) {
+    size_t n = a.size()-1;
+    size_t i = simd_partition_less(a.data(), n, pivot);
+    m.comparisons += n; m.swaps += n;
+    moved = true;
+    swap_do(a[i], a[n], m);
+    return i;
+  } else {
+    return partition_block(a, pivot, m, moved);
+  }
+}
+// Multi-pivot sampling: sorts 5 evenly spaced elements in place and returns
+// their positions, so pivots can be taken as tertiles/quartiles of the sample.
+template<class T, class M>
+static void sample5_sorted(std::span<T> a, size_t (&e)[5], M& m) {
+  size_t n = a.size(), seventh = n/7, mid = n/2;
+  e[2] = mid; e[1] = mid - seventh; e[0] = e[1] - seventh;
+  e[3] = mid + seventh; e[4] = e[3] + seventh;
+  for (int i=1;i<5;++i)
+    for (int j=i; j>0 && less_cmp(a[e[j]], a[e[j-1]], m); --j) swap_do(a[e[j]], a[e[j-1]], m);
+}
+
+// Yaroslavskiy dual-pivot partition. Expects p=a.front() <= q=a.back();
+// on return a[lt]==p, a[gt]==q, [0,lt) < p, [lt+1,gt) in [p,q], (gt,n) > q.
+template<class T, class M>
+static void partition_dual(std::span<T> a, size_t& lt, size_t& gt, M& m) {
+  const T p = a.front(), q = a.back();
+  size_t l = 1, g = a.size()-2, k = 1;
+  while (k <= g) {
+    if (less_cmp(a[k], p, m)) { swap_do(a[k], a[l], m); ++l; }
+    else if (less_cmp(q, a[k], m)) {
+      while (k < g && less_cmp(q, a[g], m)) --g;
+      swap_do(a[k], a[g], m); --g;
+      if (less_cmp(a[k], p, m)) { swap_do(a[k], a[l], m); ++l; }
+    }
+    ++k;
+  }
+  --l; ++g;
+  swap_do(a[0], a[l], m);
+  swap_do(a[a.size()-1], a[g], m);
+  lt = l; gt = g;
+}
+
+// Three-pivot partition (Kushagra et al.). Expects p=a[0] <= q=a[1] <= r=a.back();
+// on return the pivots sit at pos[0..2] with the four groups between them.
+template<class T, class M>
+static void partition_triple(std::span<T> a, size_t (&pos)[3], M& m) {
+  using idx = std::ptrdiff_t;
+  const idx hi = idx(a.size())-1;
+  const T p = a[0], q = a[1], r = a[hi];
+  idx i = 2, b = 2, c = hi-1, d = hi-1;
+  while (b <= c) {
+    while (b <= c && less_cmp(a[b], q, m)) {
+      if (less_cmp(a[b], p, m)) { swap_do(a[i], a[b], m); ++i; }
+      ++b;
+    }
+    while (b <= c && less_cmp(q, a[c], m)) {
+      if (less_cmp(r, a[c], m)) { swap_do(a[c], a[d], m); --d; }
+      --c;
+    }
+    if (b <= c) {
+      bool bigB = less_cmp(r, a[b], m);
+      if (less_cmp(a[c], p, m)) { swap_do(a[b], a[i], m); swap_do(a[i], a[c], m); ++i; }
+      else swap_do(a[b], a[c], m);
+      if (bigB) { swap_do(a[c], a[d], m); --d; }
+      ++b; --c;
+    }
+  }
+  --i; --b; ++c; ++d;
+  swap_do(a[1], a[i], m); swap_do(a[i], a[b], m); --i;
+  swap_do(a[0], a[i], m); swap_do(a[hi], a[d], m);
+  pos[0] = size_t(i); pos[1] = size_t(b); pos[2] = size_t(d);
+}
+
+// Dutch-flag three-way partition: [0,lt) < pivot, [lt,gt) == pivot, [gt,n) > pivot
+template<class T, class M>
+static void partition_3way(std::span<T> a, T pivot, size_t& lt, size_t& gt, M& m, bool& moved) {
+  size_t l = 0, i = 0, g = a.size();
+  while (i < g) {
+    if (less_cmp(a[i], pivot, m))      { moved |= (l != i); swap_do(a[l], a[i], m); ++l; ++i; }
+    else if (less_cmp(pivot, a[i], m)) { --g; moved |= (g != i); swap_do(a[i], a[g], m); }
+    else ++i;
+  }
+  lt = l; gt = g;
+}
+
+// pdqsort "partition left": used when the pivot equals the slice predecessor, so no
+// element is smaller and everything not greater than the pivot is equal to it.
+// Moves the equal run to the front and returns its length.
+template<class T, class M>
+static size_t partition_equal_left(std::span<T> a, T pivot, M& m) {
+  size_t i = 0;
+  for (size_t j=0;j<a.size();++j)
+    if (!less_cmp(pivot, a[j], m)) { swap_do(a[i], a[j], m); ++i; }
+  return i;
+}
+
+// pdqsort partial insertion sort: gives up (returning false) once more than
+// kPartialInsertLimit elements had to be shifted, so it is cheap on random data.
+static constexpr size_t kPartialInsertLimit = 8;
+template<class T, class M>
+static bool partial_insertion_sort(std::span<T> a, M& m) {
+  size_t limit = 0;
+  for (size_t i=1;i<a.size();++i) {
+    if (limit > kPartialInsertLimit) return false;
+    T key = a[i];
+    size_t j = i;
+    while (j>0 && less_cmp(key, a[j-1], m)) { a[j] = a[j-1]; ++m.swaps; --j; }
+    a[j] = key;
+    limit += i - j;
+  }
+  return true;
+}
+
+// pdqsort pattern breaking: after a very unbalanced split, swap a few elements
+// from the quarter points to the ends so a repeating pattern can't keep hitting it
+template<class T, class M>
+static void break_patterns(std::span<T> a, M& m) {
+  size_t s = a.size();
+  if (s < 16) return;
+  swap_do(a[0], a[s/4], m);
+  swap_do(a[s-1], a[s - s/4], m);
+  if (s > 128) {
+    swap_do(a[1], a[s/4+1], m);
+    swap_do(a[2], a[s/4+2], m);
+    swap_do(a[s-2], a[s - (s/4+1)], m);
+    swap_do(a[s-3], a[s - (s/4+2)], m);
+  }
+}
+
+// Parallel mode state shared by all tasks of one quicksort() call. Tasks count
+// into their own metrics and merge them here when they finish.
+template<class M>
+struct QSParallel {
+  TaskGroup group;
+  size_t grain;
+  unsigned threads;
+  std::mutex mtx;
+  M* root;
+  QSParallel(TaskPool& pool, size_t g, unsigned t, M* r) : group(pool, task_limit(t)), grain(g), threads(t), root(r) {}
+  void merge(const M& lm) {
+    std::lock_guard<std::mutex> lk(mtx);
+    root->comparisons += lm.comparisons;
+    root->swaps += lm.swaps;
+    root->auxBytes += lm.auxBytes; // fallback sorts may run concurrently
+  }
+};
+
+// Parallel partition for large slices (pivot at the back, Lomuto contract):
+// chunks are partitioned concurrently around the same pivot, then the ">="
+// elements left of the global boundary are swapped with the "<" elements right
+// of it, with those swaps spread over the pool as well.
+template<class T, class M>
+static size_t partition_parallel(std::span<T> a, T pivot, M& m, QSParallel<M>& par) {
+  struct Run { size_t start, len; };
+  const size_t n = a.size()-1;
+  const unsigned nt = par.threads;
+  const size_t chunk = (n + nt - 1) / nt;
+  std::vector<size_t> lo(nt), mid(nt), hi(nt);
+  {
+    TaskGroup g(par.group.pool(), par.group.limit());
+    for (unsigned t=0;t<nt;++t) {
+      lo[t] = std::min(n, t*chunk); hi[t] = std::min(n, lo[t] + chunk);
+      g.run([&, t]{ mid[t] = lo[t] + partition_less(a.data() + lo[t], hi[t] - lo[t], pivot); });
+    }
+    g.wait();
+  }
+  size_t B = 0;
+  for (unsigned t=0;t<nt;++t) B += mid[t] - lo[t];
+  // misplaced runs and their running offsets (both lists hold the same count)
+  std::vector<Run> bad, good;
+  std::vector<size_t> badAt{0}, goodAt{0};
+  for (unsigned t=0;t<nt;++t) {
+    size_t s = mid[t], e = std::min(hi[t], B);
+    if (s < e) { bad.push_back({s, e-s}); badAt.push_back(badAt.back() + (e-s)); }
+    s = std::max(lo[t], B); e = mid[t];
+    if (s < e) { good.push_back({s, e-s}); goodAt.push_back(goodAt.back() + (e-s)); }
+  }
+  const size_t K = badAt.back();
+  auto locate = [](const std::vector<size_t>& at, size_t k) {
+    size_t r = size_t(std::upper_bound(at.begin(), at.end(), k) - at.begin()) - 1;
+    return std::pair<size_t, size_t>{r, k - at[r]};
+  };
+  {
+    TaskGroup g(par.group.pool(), par.group.limit());
+    const size_t per = (K + nt - 1) / std::max<size_t>(1, nt);
+    for (size_t k0=0;k0<K;k0+=per) {
+      g.run([&, k0]{
+        size_t k1 = std::min(K, k0 + per);
+        auto [bi, bo] = locate(badAt, k0);
+        auto [gi, go] = locate(goodAt, k0);
+        for (size_t k=k0;k<k1;++k) {
+          std::swap(a[bad[bi].start + bo], a[good[gi].start + go]);
+          if (++bo == bad[bi].len)  { ++bi; bo = 0; }
+          if (++go == good[gi].len) { ++gi; go = 0; }
+        }
+      });
+    }
+    g.wait();
+  }
+  m.comparisons += n; m.swaps += n + K;
+  swap_do(a[B], a[n], m);
+  return B;
+}
+
+// pred points at the element just before the slice (<= every element in it), or is null.
+// par is null for serial sorts.
+template<class T, class M, class D>
+static void qs_impl(std::span<T> a, const D& dna, M& m, int depthLeft, const T* pred, QSParallel<M>* par);
+
+// recursion point: slices at or above the grain become tasks when running in parallel
+template<class T, class M, class D>
+static void qs_recurse(std::span<T> a, const D& dna, M& m, int depthLeft, const T* pred, QSParallel<M>* par) {
+  if (par && a.size() >= par->grain) {
+    par->group.run([a, &dna, depthLeft, pred, par]{
+      M lm;
+      qs_impl(a, dna, lm, depthLeft, pred, par);
+      par->merge(lm);
+    });
+  } else {
+    qs_impl(a, dna, m, depthLeft, pred, par);
+  }
+}
+
+template<class T, class M, class D>
+static void qs_multi(std::span<T> a, const D& dna, M& m, int depthLeft, const T* pred, QSParallel<M>* par) {
+  // multi-pivot: pivots come from a sorted 5-sample, equal-pivot groups are already done
+  size_t e[5];
+  sample5_sorted(a, e, m);
   size_t last = a.size()-1;
-  // find a position equal to pv and swap to end
-  for (size_t k=0;k<a.size();++k) if (a[k]==pv) { swap_do(a[k], a[last], m); break; }
-  size_t cut;
-  if (dna.scheme == PartitionScheme::Lomuto) {
-    cut = partition_lomuto(a, pv, m);
-    auto L = a.first(cut);
-    auto R = a.subspan(cut+1);
-    qs_impl(L, dna, m, depthLeft-1);
-    qs_impl(R, dna, m, depthLeft-1);
+  if (dna.pivotCount == 2) {
+    swap_do(a[e[1]], a[0], m); swap_do(a[e[3]], a[last], m);
+    size_t lt, gt;
+    partition_dual(a, lt, gt, m);
+    qs_recurse(a.first(lt), dna, m, depthLeft, pred, par);
+    if (less_cmp(a[lt], a[gt], m)) qs_recurse(a.subspan(lt+1, gt-lt-1), dna, m, depthLeft, &a[lt], par);
+    qs_impl(a.subspan(gt+1), dna, m, depthLeft, &a[gt], par);
   } else {
-    size_t idx = partition_hoare(a, pv, m);
-    auto L = a.first(idx+1);
-    auto R = a.subspan(idx+1);
-    if (dna.tailRecElim) {
-      // Recurse smaller part first and then loop on larger part
-      while (true) {
-        auto left = (L.size() < R.size()) ? L : R;
-        auto right= (L.size() < R.size()) ? R : L;
-        qs_impl(left, dna, m, depthLeft-1);
-        if (right.size() <= 1) break;
-        // tail call elimination by reassigning a slice
-        a = right;
-        pv = pivot_choose(a, dna.pivot, m);
-        last = a.size()-1;
-        for (size_t k=0;k<a.size();++k) if (a[k]==pv) { swap_do(a[k], a[last], m); break; }
-        idx = partition_hoare(a, pv, m);
-        L = a.first(idx+1); R = a.subspan(idx+1);
-        if (R.size() <= 1 && L.size() <= 1) break;
-      }
+    swap_do(a[e[1]], a[0], m); swap_do(a[e[2]], a[1], m); swap_do(a[e[3]], a[last], m);
+    size_t pos[3];
+    partition_triple(a, pos, m);
+    qs_recurse(a.first(pos[0]), dna, m, depthLeft, pred, par);
+    if (less_cmp(a[pos[0]], a[pos[1]], m)) qs_recurse(a.subspan(pos[0]+1, pos[1]-pos[0]-1), dna, m, depthLeft, &a[pos[0]], par);
+    if (less_cmp(a[pos[1]], a[pos[2]], m)) qs_recurse(a.subspan(pos[1]+1, pos[2]-pos[1]-1), dna, m, depthLeft, &a[pos[1]], par);
+    qs_impl(a.subspan(pos[2]+1), dna, m, depthLeft, &a[pos[2]], par);
+  }
+}
+
+template<class T, class M, class D>
+static void qs_impl(std::span<T> a, const D& dna, M& m, int depthLeft, const T* pred, QSParallel<M>* par) {
+  while (a.size() > 1) {
+    if ((int)a.size() <= dna.insertionCutoff) {
+      small_sort(a, dna.smallSortKind, m, (pred && pred + 1 == a.data()) ? pred : nullptr);
+      return;
+    }
+    if (depthLeft <= 0) { depth_fallback(a, dna, m); return; }
+    --depthLeft; // both halves (and the tail loop) are one level deeper
+    if (dna.pivotCount >= 2 && a.size() >= 16) { qs_multi(a, dna, m, depthLeft, pred, par); return; }
+    size_t pi = pivot_index(a, dna.pivot, m);
+    T pv = a[pi];
+    if (dna.equalLeft && pred && !less_cmp(*pred, pv, m)) {
+      // pivot == predecessor: the equal run is final, only the greater side is left
+      size_t eq = partition_equal_left(a, pv, m);
+      pred = &a[eq-1];
+      a = a.subspan(eq);
+      continue;
+    }
+    std::span<T> L, R;
+    const T* predR;
+    bool moved = false;
+    if (par && a.size() >= par->grain * par->threads) {
+      // big enough that every thread gets at least a grain of it
+      swap_do(a[pi], a[a.size()-1], m);
+      size_t cut = partition_parallel(a, pv, m, *par);
+      moved = true;
+      L = a.first(cut); R = a.subspan(cut+1); predR = &a[cut];
+    } else if (dna.scheme == PartitionScheme::Lomuto || dna.scheme == PartitionScheme::Block || dna.scheme == PartitionScheme::Simd) {
+      // Lomuto/Block/Simd expect the pivot at the end
+      swap_do(a[pi], a[a.size()-1], m);
+      size_t cut = (dna.scheme == PartitionScheme::Lomuto) ? partition_lomuto(a, pv, m, moved)
+                 : (dna.scheme == PartitionScheme::Block)  ? partition_block(a, pv, m, moved)
+                                                           : partition_simd(a, pv, m, moved);
+      L = a.first(cut); R = a.subspan(cut+1); predR = &a[cut];
+    } else if (dna.scheme == PartitionScheme::ThreeWay) {
+      size_t lt, gt;
+      partition_3way(a, pv, lt, gt, m, moved); // pv comes from a, so gt > lt
+      L = a.first(lt); R = a.subspan(gt); predR = &a[gt-1];
     } else {
-      qs_impl(L, dna, m, depthLeft-1);
-      qs_impl(R, dna, m, depthLeft-1);
+      // Hoare wants the pivot in front so the split never returns the whole slice
+      swap_do(a[pi], a[0], m);
+      size_t idx = partition_hoare(a, pv, m, moved);
+      // a[idx] belongs to L, which may be sorted concurrently in parallel mode
+      L = a.first(idx+1); R = a.subspan(idx+1); predR = par ? nullptr : &a[idx];
     }
+    bool unbalanced = L.size() < a.size()/8 || R.size() < a.size()/8;
+    if (unbalanced) {
+      if (dna.patternShuffle) { break_patterns(L, m); break_patterns(R, m); }
+    } else if (dna.presortCheck && !moved) {
+      // nothing moved: the input was likely presorted, try to finish both sides cheaply
+      bool okL = partial_insertion_sort(L, m), okR = partial_insertion_sort(R, m);
+      if (okL && okR) return;
+      if (okL) { a = R; pred = predR; continue; }
+      if (okR) { a = L; continue; }
+    }
+    if (!dna.tailRecElim) {
+      qs_recurse(L, dna, m, depthLeft, pred, par);
+      qs_impl(R, dna, m, depthLeft, predR, par);
+      return;
+    }
+    // Recurse smaller part first and then loop on larger part
+    if (L.size() < R.size()) { qs_recurse(L, dna, m, depthLeft, pred, par); a = R; pred = predR; }
+    else                     { qs_recurse(R, dna, m, depthLeft, predR, par); a = L; }
   }
 }
-void quicksort(std::span<int> a, const QSDNA& dna, Metrics& m) {
+// D is QSDNA, a QSKernel table entry, or QSFixed<V> for quicksort_fixed.
+template<class T, class M, class D>
+static void qs_entry(std::span<T> a, const D& dna, M& m) {
+  if (counting_sort_small_range(a, dna.countingThreshold, m)) return;
   int depth = dna.depthCap > 0 ? dna.depthCap : 64;
-  qs_impl(a, dna, m, depth);
+  size_t grain = (size_t)std::max(1, dna.parallelGrain);
+  if (dna.threads > 1 && a.size() >= 2*grain) {
+    QSParallel<M> par(shared_task_pool(), grain, (unsigned)dna.threads, &m);
+    M local;
+    qs_impl<T, M>(a, dna, local, depth, nullptr, &par);
+    par.group.wait();
+    par.merge(local);
+    return;
+  }
+  qs_impl<T, M>(a, dna, m, depth, nullptr, nullptr);
+}
+// Kernel table: one instantiation per (pivot, scheme, tailRecElim), picked
+// once per call, so partitioning and pivot selection are inlined per variant
+// instead of being re-dispatched at every recursion level.
+constexpr size_t kPivots = size_t(Pivot::Sampled) + 1;
+constexpr size_t kSchemes = size_t(PartitionScheme::Simd) + 1;
+template<class T, class M>
+using QSKernelFn = void (*)(std::span<T>, const QSDNA&, M&);
+template<class T, class M, size_t I>
+static void qs_kernel(std::span<T> a, const QSDNA& dna, M& m) {
+  constexpr Pivot p = Pivot(I % kPivots);
+  constexpr PartitionScheme s = PartitionScheme(I / kPivots % kSchemes);
+  qs_entry(a, QSKernel<p, s, (I / (kPivots*kSchemes) != 0)>(dna), m);
+}
+template<class T, class M, size_t... I>
+static constexpr std::array<QSKernelFn<T, M>, sizeof...(I)> qs_kernel_table(std::index_sequence<I...>) {
+  return {&qs_kernel<T, M, I>...};
 }
+template<class T, class M>
+void quicksort(std::span<T> a, const QSDNA& dna, M& m) {
+#ifdef ALGO_EVO_TUNED
+  qs_entry(a, dna, m); // the tuned library itself only runs quicksort_fixed
+#else
+  if constexpr (std::is_same_v<M, NullMetrics>) {
+    static constexpr auto table = qs_kernel_table<T, M>(std::make_index_sequence<kPivots*kSchemes*2>{});
+    const size_t i = size_t(dna.pivot) + kPivots*(size_t(dna.scheme) + kSchemes*size_t(dna.tailRecElim));
+    assert(i < table.size());
+    table[i](a, dna, m);
+  } else {
+    qs_entry(a, dna, m); // counting runs are untimed, one generic kernel serves them
+  }
+#endif
+}
+template<QSDNA V, class T, class M>
+void quicksort_fixed(std::span<T> a, M& m) {
+  qs_entry(a, QSFixed<V>{}, m);
+}
+#define QS_INSTANTIATE(T) \
+  template void quicksort<T, Metrics>(std::span<T>, const QSDNA&, Metrics&); \
+  template void quicksort<T, NullMetrics>(std::span<T>, const QSDNA&, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(QS_INSTANTIATE)
+
+#ifdef ALGO_EVO_TUNED
+// tuned_sort library build: the kernels once more, on the generated DNA.
+#include "tuned_dna.hpp"
+#define QS_TUNED_INSTANTIATE(T) \
+  template void quicksort_fixed<kTunedQS, T, NullMetrics>(std::span<T>, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(QS_TUNED_INSTANTIATE)
+#endif
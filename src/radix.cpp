@@ -0,0 +1,171 @@
+#include "radix.hpp"
+#include "quicksort.hpp"
+#include "scratch.hpp"
+#include "elem.hpp"
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ALGO_EVO_PREFETCH_W(p) __builtin_prefetch((p), 1)
+#else
+#define ALGO_EVO_PREFETCH_W(p) ((void)0)
+#endif
+
+// Order-preserving unsigned key of each element type.
+template<class T> struct RadixKey;
+template<> struct RadixKey<int> {
+  using K = uint32_t;
+  static K get(int v) { return uint32_t(v) ^ 0x80000000u; }
+};
+template<> struct RadixKey<int64_t> {
+  using K = uint64_t;
+  static K get(int64_t v) { return uint64_t(v) ^ (uint64_t(1) << 63); }
+};
+template<> struct RadixKey<float> {
+  using K = uint32_t;
+  static K get(float v) { K b = std::bit_cast<K>(v); return (b & 0x80000000u) ? ~b : b | 0x80000000u; }
+};
+template<> struct RadixKey<double> {
+  using K = uint64_t;
+  static K get(double v) {
+    K b = std::bit_cast<K>(v);
+    return (b >> 63) ? ~b : b | (uint64_t(1) << 63);
+  }
+};
+template<> struct RadixKey<Record> {
+  using K = uint64_t;
+  static K get(const Record& r) { return r.key; }
+};
+
+// How far ahead of the scatter cursor the prefetch gene looks.
+constexpr size_t kPrefetchAhead = 16;
+
+template<class T>
+struct Digits {
+  using K = typename RadixKey<T>::K;
+  static constexpr unsigned kKeyBits = sizeof(K) * 8;
+  unsigned bits, passes;
+  explicit Digits(int digitBits)
+    : bits((unsigned)std::clamp(digitBits, 4, 16)), passes((kKeyBits + bits - 1) / bits) {}
+  // digit p counted from the least significant end
+  size_t at(const T& v, unsigned p) const {
+    unsigned shift = p * bits;
+    return size_t((RadixKey<T>::get(v) >> shift) & ((K(1) << std::min(bits, kKeyBits - shift)) - 1));
+  }
+  size_t buckets() const { return size_t(1) << bits; }
+};
+
+// Stable counting scatter of src into dst on digit p; `pos` holds the bucket
+// starts and is advanced.
+template<class T, class M>
+static void scatter(std::span<T> src, T* dst, size_t* pos, const Digits<T>& dg, unsigned p, bool prefetch, M& m) {
+  const size_t n = src.size();
+  for (size_t i=0; i<n; ++i) {
+    if (prefetch && i + kPrefetchAhead < n) ALGO_EVO_PREFETCH_W(dst + pos[dg.at(src[i + kPrefetchAhead], p)]);
+    dst[pos[dg.at(src[i], p)]++] = src[i];
+    ++m.swaps;
+  }
+}
+
+// LSD: one read pass builds every digit's histogram, then one stable scatter
+// per digit ping-pongs through the scratch buffer. A digit all keys share is
+// skipped.
+template<class T, class M>
+static void radix_lsd(std::span<T> a, const RadixDNA& dna, M& m) {
+  const size_t n = a.size();
+  const Digits<T> dg(dna.digitBits);
+  const size_t nb = dg.buckets();
+  std::vector<size_t> count(dg.passes * nb, 0);
+  for (const T& v : a)
+    for (unsigned p=0; p<dg.passes; ++p) ++count[p*nb + dg.at(v, p)];
+  ScratchLease lease(n * sizeof(T));
+  note_aux(m, n * sizeof(T) + count.size() * sizeof(size_t));
+  std::span<T> src = a, dst = lease.as<T>(n);
+  for (unsigned p=0; p<dg.passes; ++p) {
+    size_t* pos = &count[p*nb];
+    if (pos[dg.at(src[0], p)] == n) continue; // every key has this digit
+    size_t sum = 0;
+    for (size_t b=0; b<nb; ++b) { size_t c = pos[b]; pos[b] = sum; sum += c; }
+    scatter(src, dst.data(), pos, dg, p, dna.prefetch, m);
+    std::swap(src, dst);
+  }
+  if (src.data() != a.data()) {
+    std::copy(src.begin(), src.end(), a.begin());
+    m.swaps += n;
+  }
+}
+
+// MSD from digit p down. Buckets at or below the fallback threshold go to the
+// default quicksort; others recurse on the next digit. Out of place the
+// bucket is scattered into tmp and copied back (stable); in place it is
+// permuted American-flag style: every element is swapped straight into the
+// next free slot of its bucket (not stable).
+template<class T, class M>
+static void radix_msd(std::span<T> a, std::span<T> tmp, const Digits<T>& dg, unsigned p,
+                      const RadixDNA& dna, std::vector<size_t>& counts, M& m) {
+  const size_t n = a.size();
+  if (n <= 1) return;
+  if (n <= (size_t)std::max(1, dna.fallbackThreshold)) { quicksort(a, QSDNA{}, m); return; }
+  const size_t nb = dg.buckets();
+  // counts holds one histogram per recursion depth, so siblings don't clash
+  const size_t depth = dg.passes - 1 - p;
+  size_t* start = &counts[depth * 2 * nb];
+  size_t* next  = start + nb;
+  std::fill(start, start + nb, 0);
+  for (const T& v : a) ++start[dg.at(v, p)];
+  if (start[dg.at(a[0], p)] == n) { // one bucket: go straight to the next digit
+    if (p > 0) radix_msd(a, tmp, dg, p-1, dna, counts, m);
+    return;
+  }
+  size_t sum = 0;
+  for (size_t b=0; b<nb; ++b) { size_t c = start[b]; start[b] = sum; next[b] = sum; sum += c; }
+  if (!dna.inPlace) {
+    scatter(a, tmp.data(), next, dg, p, dna.prefetch, m);
+    std::copy(tmp.begin(), tmp.begin() + n, a.begin());
+    m.swaps += n;
+  } else {
+    for (size_t b=0; b<nb; ++b) {
+      const size_t end = b+1 < nb ? start[b+1] : n;
+      while (next[b] < end) {
+        T v = a[next[b]];
+        size_t d = dg.at(v, p);
+        while (d != b) {
+          if (dna.prefetch) ALGO_EVO_PREFETCH_W(&a[next[dg.at(a[next[d]], p)]]);
+          std::swap(v, a[next[d]++]);
+          ++m.swaps;
+          d = dg.at(v, p);
+        }
+        a[next[b]++] = v;
+        ++m.swaps;
+      }
+    }
+  }
+  if (p == 0) return;
+  for (size_t b=0; b<nb; ++b) {
+    const size_t lo = start[b], hi = b+1 < nb ? start[b+1] : n;
+    radix_msd(a.subspan(lo, hi-lo), tmp.empty() ? tmp : tmp.first(hi-lo), dg, p-1, dna, counts, m);
+  }
+}
+
+template<class T, class M>
+void radix_sort(std::span<T> a, const RadixDNA& dna, M& m) {
+  const size_t n = a.size();
+  if (n <= 1) return;
+  if (n <= (size_t)std::max(0, dna.fallbackThreshold)) { quicksort(a, QSDNA{}, m); return; }
+  if (dna.order == RadixOrder::LSD) { radix_lsd(a, dna, m); return; }
+  const Digits<T> dg(dna.digitBits);
+  std::vector<size_t> counts(dg.passes * 2 * dg.buckets());
+  std::optional<ScratchLease> lease;
+  std::span<T> tmp;
+  if (!dna.inPlace) { lease.emplace(n * sizeof(T)); tmp = lease->template as<T>(n); }
+  note_aux(m, tmp.size() * sizeof(T) + counts.size() * sizeof(size_t));
+  radix_msd(a, tmp, dg, dg.passes - 1, dna, counts, m);
+}
+
+#define RADIX_INSTANTIATE(T) \
+  template void radix_sort<T, Metrics>(std::span<T>, const RadixDNA&, Metrics&); \
+  template void radix_sort<T, NullMetrics>(std::span<T>, const RadixDNA&, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(RADIX_INSTANTIATE)
@@ -2,21 +2,70 @@
 #include "common.hpp"
 #include <cmath>
 #include <algorithm>
+#include <thread>
 // simple neighbor tweaks code below
+static int max_threads() { return (int)std::max(1u, std::thread::hardware_concurrency()); }
 static QSDNA nudge(QSDNA d, XRand& rng) {
   double p = rng.uniform01();
-  if (p < 0.20) d.pivot = (Pivot)(rng.uniform(0,2));
-  else if (p < 0.40) d.scheme = (PartitionScheme)(rng.uniform(0,1));
-  else if (p < 0.65) d.insertionCutoff = std::clamp(d.insertionCutoff + int(rng.uniform(0,7))-3, 0, 64);
-  else if (p < 0.90) d.depthCap       = std::clamp(d.depthCap       + int(rng.uniform(0,7))-3, 32, 128);
+  if (p < 0.10) d.pivot = (Pivot)(rng.uniform(0,5));
+  else if (p < 0.20) d.scheme = (PartitionScheme)(rng.uniform(0,4));
+  else if (p < 0.32) d.insertionCutoff = std::clamp(d.insertionCutoff + int(rng.uniform(0,7))-3, 0, 64);
+  else if (p < 0.43) d.depthCap       = std::clamp(d.depthCap       + int(rng.uniform(0,7))-3, 32, 128);
+  else if (p < 0.51) d.smallSortKind = (SmallSort)(rng.uniform(0,3));
+  else if (p < 0.58) d.pivotCount = int(rng.uniform(1,3));
+  else if (p < 0.65) d.depthFallback = (DepthFallback)(rng.uniform(0,2));
+  else if (p < 0.71) d.equalLeft = !d.equalLeft;
+  else if (p < 0.77) d.presortCheck = !d.presortCheck;
+  else if (p < 0.83) d.patternShuffle = !d.patternShuffle;
+  else if (p < 0.88) d.threads = std::clamp(d.threads + int(rng.uniform(0,2))-1, 1, max_threads());
+  else if (p < 0.92) d.parallelGrain = std::clamp(rng.uniform(0,1) ? d.parallelGrain*2 : d.parallelGrain/2, 1024, 1<<20);
+  else if (p < 0.97) d.countingThreshold = std::clamp(rng.uniform(0,1) ? std::max(64, d.countingThreshold)*2 : d.countingThreshold/2, 0, 1<<20);
   else d.tailRecElim = !d.tailRecElim;
   return d;
 }
 static MSDNA nudge(MSDNA d, XRand& rng) {
   double p = rng.uniform01();
-  if (p < 0.55) d.runThreshold = std::clamp(d.runThreshold + int(rng.uniform(0,7))-3, 0, 64);
-  else if (p < 0.80) d.iterative   = !d.iterative;
-  else d.reuseBuffer = !d.reuseBuffer;
+  if (p < 0.16) d.runThreshold = std::clamp(d.runThreshold + int(rng.uniform(0,7))-3, 0, 64);
+  else if (p < 0.22) d.iterative   = !d.iterative;
+  else if (p < 0.26) d.inPlace     = !d.inPlace;
+  else if (p < 0.30) d.inPlaceBuffer = std::clamp(rng.uniform(0,1) ? std::max(1, d.inPlaceBuffer)*2 : d.inPlaceBuffer/2, 0, 4096);
+  else if (p < 0.34) d.reuseBuffer = !d.reuseBuffer;
+  else if (p < 0.40) d.buffer = (MergeBuffer)(rng.uniform(0,1));
+  else if (p < 0.47) d.mergeArity = std::clamp(rng.uniform(0,1) ? d.mergeArity*2 : d.mergeArity/2, 2, 16);
+  else if (p < 0.53) d.mergeKernel = (MergeKernel)(rng.uniform(0,2));
+  else if (p < 0.61) d.natural = !d.natural;
+  else if (p < 0.68) d.minRun = std::clamp(d.minRun + int(rng.uniform(0,8))-4, 8, 64);
+  else if (p < 0.75) d.minGallop = std::clamp(d.minGallop + int(rng.uniform(0,4))-2, 1, 64);
+  else if (p < 0.84) d.smallSortKind = (SmallSort)(rng.uniform(0,2)); // no Network: not stable
+  else if (p < 0.90) d.threads = std::clamp(d.threads + int(rng.uniform(0,2))-1, 1, max_threads());
+  else if (p < 0.95) d.parallelGrain = std::clamp(rng.uniform(0,1) ? d.parallelGrain*2 : d.parallelGrain/2, 1024, 1<<20);
+  else d.countingThreshold = std::clamp(rng.uniform(0,1) ? std::max(64, d.countingThreshold)*2 : d.countingThreshold/2, 0, 1<<20);
+  return d;
+}
+static RadixDNA nudge(RadixDNA d, XRand& rng) {
+  double p = rng.uniform01();
+  if (p < 0.35) d.digitBits = std::clamp(d.digitBits + int(rng.uniform(0,4))-2, 4, 16);
+  else if (p < 0.50) d.order = (RadixOrder)(rng.uniform(0,1));
+  else if (p < 0.65) d.inPlace = !d.inPlace;
+  else if (p < 0.85) d.fallbackThreshold = std::clamp(rng.uniform(0,1) ? std::max(1, d.fallbackThreshold)*2 : d.fallbackThreshold/2, 0, 4096);
+  else d.prefetch = !d.prefetch;
+  return d;
+}
+static SampleDNA nudge(SampleDNA d, XRand& rng) {
+  double p = rng.uniform01();
+  if (p < 0.20) d.buckets = std::clamp(rng.uniform(0,1) ? d.buckets*2 : d.buckets/2, 4, 256);
+  else if (p < 0.40) d.oversample = std::clamp(d.oversample + int(rng.uniform(0,4))-2, 1, 32);
+  else if (p < 0.55) d.baseCase = (SampleBase)(rng.uniform(0,2));
+  else if (p < 0.75) d.baseThreshold = std::clamp(rng.uniform(0,1) ? d.baseThreshold*2 : d.baseThreshold/2, 256, 65536);
+  else if (p < 0.88) d.threads = std::clamp(d.threads + int(rng.uniform(0,2))-1, 1, max_threads());
+  else d.parallelGrain = std::clamp(rng.uniform(0,1) ? d.parallelGrain*2 : d.parallelGrain/2, 1024, 1<<20);
+  return d;
+}
+static LearnedDNA nudge(LearnedDNA d, XRand& rng) {
+  double p = rng.uniform01();
+  if (p < 0.34) d.samplePermille = std::clamp(d.samplePermille + int(rng.uniform(0,8))-4, 1, 100);
+  else if (p < 0.67) d.segments = std::clamp(rng.uniform(0,1) ? d.segments*2 : d.segments/2, 16, 4096);
+  else d.fanout = std::clamp(rng.uniform(0,1) ? d.fanout*2 : d.fanout/2, 16, 4096);
   return d;
 }
 template<class DNA>
@@ -52,3 +101,6 @@ DNA run_sa(EvalFnSA<DNA> eval, int steps, double t0, double t1, uint64_t seed,
 // instantiate
 template QSDNA run_sa<QSDNA>(EvalFnSA<QSDNA>, int, double, double, uint64_t, std::vector<double>*, LogFnSA<QSDNA>);
 template MSDNA run_sa<MSDNA>(EvalFnSA<MSDNA>, int, double, double, uint64_t, std::vector<double>*, LogFnSA<MSDNA>);
+template RadixDNA run_sa<RadixDNA>(EvalFnSA<RadixDNA>, int, double, double, uint64_t, std::vector<double>*, LogFnSA<RadixDNA>);
+template SampleDNA run_sa<SampleDNA>(EvalFnSA<SampleDNA>, int, double, double, uint64_t, std::vector<double>*, LogFnSA<SampleDNA>);
+template LearnedDNA run_sa<LearnedDNA>(EvalFnSA<LearnedDNA>, int, double, double, uint64_t, std::vector<double>*, LogFnSA<LearnedDNA>);
@@ -0,0 +1,215 @@
+#include "samplesort.hpp"
+#include "quicksort.hpp"
+#include "mergesort.hpp"
+#include "radix.hpp"
+#include "scratch.hpp"
+#include "task_pool.hpp"
+#include "common.hpp"
+#include "elem.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+template<class T, class M>
+static inline bool less_cmp(const T& a, const T& b, M& m) { ++m.comparisons; return a < b; }
+
+// Recursion levels before a slice goes to the base case regardless of size;
+// only reached when the samples keep missing the distribution.
+constexpr int kMaxDepth = 24;
+
+// Super scalar samplesort classifier: K-1 sorted splitters laid out as an
+// implicit perfect search tree, walked without branches. Element x lands in
+// bucket 2b, b = #splitters < x, or in the equality bucket 2b+1 when it equals
+// splitter b, so runs of duplicates leave the recursion after one level.
+template<class T>
+struct Classifier {
+  size_t K = 0;
+  unsigned logK = 0;
+  std::vector<T> tree;    // tree[1..K-1], children of i at 2i and 2i+1
+  std::vector<T> sp;      // the splitters in order
+
+  template<class M>
+  Classifier(std::span<T> a, size_t K_, size_t oversample, uint64_t seed, M& m)
+    : K(K_), logK((unsigned)std::countr_zero(K_)), tree(K_), sp(K_-1) {
+    const size_t n = a.size(), S = std::min(K * oversample, n / 2);
+    std::vector<T> sample(S);
+    XRand rng(seed);
+    for (auto& s : sample) s = a[rng.uniform(0, n-1)];
+    quicksort(std::span<T>(sample), QSDNA{}, m);
+    for (size_t i=0; i+1<K; ++i) sp[i] = sample[(i+1) * S / K];
+    build(1, 0, K-1);
+  }
+  void build(size_t node, size_t lo, size_t hi) {
+    if (lo >= hi) return;
+    size_t mid = lo + (hi-lo)/2;
+    tree[node] = sp[mid];
+    build(2*node, lo, mid);
+    build(2*node+1, mid+1, hi);
+  }
+  template<class M>
+  size_t bucket(const T& x, M& m) const {
+    size_t i = 1;
+    for (unsigned l=0; l<logK; ++l) i = 2*i + less_cmp(tree[i], x, m);
+    const size_t b = i - K;
+    return 2*b + (b+1 < K && !less_cmp(x, sp[b], m));
+  }
+  // Classifies a[0,n) into oracle and adds to count. Four elements walk the
+  // tree side by side, so their loads and compares overlap.
+  template<class M>
+  void classify(std::span<const T> a, uint16_t* oracle, size_t* count, M& m) const {
+    const size_t n = a.size();
+    size_t i = 0;
+    for (; i+4 <= n; i += 4) {
+      size_t j0 = 1, j1 = 1, j2 = 1, j3 = 1;
+      for (unsigned l=0; l<logK; ++l) {
+        j0 = 2*j0 + less_cmp(tree[j0], a[i], m);
+        j1 = 2*j1 + less_cmp(tree[j1], a[i+1], m);
+        j2 = 2*j2 + less_cmp(tree[j2], a[i+2], m);
+        j3 = 2*j3 + less_cmp(tree[j3], a[i+3], m);
+      }
+      const size_t js[4] = {j0, j1, j2, j3};
+      for (size_t k=0; k<4; ++k) {
+        const size_t b = js[k] - K;
+        const size_t c = 2*b + (b+1 < K && !less_cmp(a[i+k], sp[b], m));
+        oracle[i+k] = uint16_t(c);
+        ++count[c];
+      }
+    }
+    for (; i<n; ++i) { size_t c = bucket(a[i], m); oracle[i] = uint16_t(c); ++count[c]; }
+  }
+};
+
+template<class T, class M>
+static void base_sort(std::span<T> a, SampleBase base, M& m) {
+  switch (base) {
+    case SampleBase::MergeSort: mergesort(a, MSDNA{}, m); break;
+    case SampleBase::Radix:     radix_sort(a, RadixDNA{}, m); break;
+    default:                    quicksort(a, QSDNA{}, m); break;
+  }
+}
+// Buckets per level for a slice of n: the gene, capped so every bucket can
+// still expect a few dozen elements.
+static size_t level_buckets(const SampleDNA& dna, size_t n) {
+  size_t K = std::bit_floor((size_t)std::clamp(dna.buckets, 4, 256));
+  return std::min(K, std::bit_floor(std::max<size_t>(4, n / 64)));
+}
+
+// One serial level: classify, scatter into tmp by the oracle, copy back, then
+// recurse into every bucket that isn't an equality bucket.
+template<class T, class M>
+static void ss_rec(std::span<T> a, std::span<T> tmp, uint16_t* oracle, const SampleDNA& dna, int depth, M& m) {
+  const size_t n = a.size();
+  if (n <= (size_t)std::max(1, dna.baseThreshold) || depth >= kMaxDepth) { base_sort(a, dna.baseCase, m); return; }
+  const size_t K = level_buckets(dna, n);
+  Classifier<T> cls(a, K, (size_t)std::max(1, dna.oversample), n * 0x9E3779B97F4A7C15ull + depth, m);
+  std::array<size_t, 512> start{};
+  cls.classify(a, oracle, start.data(), m);
+  size_t sum = 0;
+  for (size_t b=0; b<2*K; ++b) { size_t c = start[b]; start[b] = sum; sum += c; }
+  std::array<size_t, 512> pos = start;
+  for (size_t i=0; i<n; ++i) { tmp[pos[oracle[i]]++] = a[i]; ++m.swaps; }
+  std::copy(tmp.begin(), tmp.begin() + n, a.begin());
+  m.swaps += n;
+  for (size_t b=0; b<2*K; b += 2) {
+    const size_t lo = start[b], hi = pos[b];
+    if (hi - lo > 1) ss_rec(a.subspan(lo, hi-lo), tmp.subspan(lo, hi-lo), oracle + lo, dna, depth+1, m);
+  }
+}
+
+// Parallel top level: every thread classifies and then scatters its own chunk
+// (offsets from per-chunk histograms, so no atomics), the copy back is split
+// the same way, and the buckets are sorted as independent tasks.
+template<class T, class M>
+static void ss_parallel(std::span<T> a, std::span<T> tmp, uint16_t* oracle, const SampleDNA& dna, M& m) {
+  const size_t n = a.size();
+  const unsigned nt = (unsigned)dna.threads;
+  const size_t grain = (size_t)std::max(1, dna.parallelGrain);
+  TaskPool& pool = shared_task_pool();
+  const size_t limit = task_limit(nt); // at most nt cores, counting this thread
+  std::mutex mtx;
+  auto merge_metrics = [&](const M& lm) {
+    std::lock_guard<std::mutex> lk(mtx);
+    m.comparisons += lm.comparisons;
+    m.swaps += lm.swaps;
+    m.auxBytes += lm.auxBytes;
+  };
+  const size_t K = level_buckets(dna, n);
+  Classifier<T> cls(a, K, (size_t)std::max(1, dna.oversample), n * 0x9E3779B97F4A7C15ull, m);
+  const size_t chunks = std::clamp<size_t>(n / grain, 1, nt);
+  const size_t width = (n + chunks - 1) / chunks;
+  std::vector<std::array<size_t, 512>> off(chunks);
+  {
+    TaskGroup g(pool, limit);
+    for (size_t c=0; c<chunks; ++c)
+      g.run([&, c]{
+        M lm;
+        const size_t lo = c*width, hi = std::min(n, lo+width);
+        off[c].fill(0);
+        cls.classify(std::span<const T>(a.data()+lo, hi-lo), oracle+lo, off[c].data(), lm);
+        merge_metrics(lm);
+      });
+    g.wait();
+  }
+  std::array<size_t, 512> start{}, end{};
+  size_t sum = 0;
+  for (size_t b=0; b<2*K; ++b) {
+    start[b] = sum;
+    for (size_t c=0; c<chunks; ++c) { size_t cnt = off[c][b]; off[c][b] = sum; sum += cnt; }
+    end[b] = sum;
+  }
+  {
+    TaskGroup g(pool, limit);
+    for (size_t c=0; c<chunks; ++c)
+      g.run([&, c]{
+        M lm;
+        const size_t lo = c*width, hi = std::min(n, lo+width);
+        auto& pos = off[c];
+        for (size_t i=lo; i<hi; ++i) { tmp[pos[oracle[i]]++] = a[i]; ++lm.swaps; }
+        merge_metrics(lm);
+      });
+    g.wait();
+  }
+  {
+    TaskGroup g(pool, limit);
+    for (size_t lo=0; lo<n; lo+=width)
+      g.run([&, lo]{
+        M lm;
+        const size_t hi = std::min(n, lo+width);
+        std::copy(tmp.begin()+lo, tmp.begin()+hi, a.begin()+lo);
+        lm.swaps += hi-lo;
+        merge_metrics(lm);
+      });
+    g.wait();
+  }
+  TaskGroup g(pool, limit);
+  for (size_t b=0; b<2*K; b += 2) {
+    const size_t lo = start[b], len = end[b] - lo;
+    if (len > 1)
+      g.run([&, lo, len]{
+        M lm;
+        ss_rec(a.subspan(lo, len), tmp.subspan(lo, len), oracle + lo, dna, 1, lm);
+        merge_metrics(lm);
+      });
+  }
+  g.wait();
+}
+
+template<class T, class M>
+void samplesort(std::span<T> a, const SampleDNA& dna, M& m) {
+  const size_t n = a.size();
+  if (n <= (size_t)std::max(1, dna.baseThreshold)) { base_sort(a, dna.baseCase, m); return; }
+  ScratchLease buf(n * sizeof(T)), ora(n * sizeof(uint16_t));
+  note_aux(m, n * (sizeof(T) + sizeof(uint16_t)));
+  std::span<T> tmp = buf.as<T>(n);
+  uint16_t* oracle = ora.as<uint16_t>(n).data();
+  if (dna.threads > 1 && n >= 2*(size_t)std::max(1, dna.parallelGrain)) ss_parallel(a, tmp, oracle, dna, m);
+  else ss_rec(a, tmp, oracle, dna, 0, m);
+}
+
+#define SS_INSTANTIATE(T) \
+  template void samplesort<T, Metrics>(std::span<T>, const SampleDNA&, Metrics&); \
+  template void samplesort<T, NullMetrics>(std::span<T>, const SampleDNA&, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(SS_INSTANTIATE)
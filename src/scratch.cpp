@@ -0,0 +1,76 @@
+#include "scratch.hpp"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+struct Block { std::unique_ptr<std::byte[]> mem; std::size_t size; };
+std::mutex g_mtx;
+std::vector<Block> g_free;             // returned blocks, reused smallest-fit
+std::size_t g_freeBytes = 0;
+std::size_t g_recent = 0;              // largest recent request, decaying by 1/16 per lease
+constexpr std::size_t kMaxPooledBytes = std::size_t(64) << 20;
+constexpr std::size_t kOversize = 4;   // blocks this far above g_recent are freed
+
+// moves pooled blocks far larger than recent requests into `out`; g_mtx held
+void drop_oversized(std::vector<Block>& out) {
+  for (std::size_t i=0;i<g_free.size();) {
+    if (g_free[i].size > kOversize*g_recent) {
+      g_freeBytes -= g_free[i].size;
+      out.push_back(std::move(g_free[i]));
+      g_free[i] = std::move(g_free.back()); g_free.pop_back();
+    } else ++i;
+  }
+}
+}
+
+// Blocks leaving the pool are collected in `drop`, declared before the lock,
+// so they are freed after it is released.
+ScratchLease::ScratchLease(std::size_t bytes) {
+  {
+    std::vector<Block> drop;
+    std::lock_guard<std::mutex> lk(g_mtx);
+    g_recent = std::max(bytes, g_recent - g_recent/16);
+    drop_oversized(drop);
+    std::size_t best = g_free.size();
+    for (std::size_t i=0;i<g_free.size();++i)
+      if (g_free[i].size >= bytes && (best == g_free.size() || g_free[i].size < g_free[best].size)) best = i;
+    if (best != g_free.size()) {
+      block_ = std::move(g_free[best].mem); size_ = g_free[best].size;
+      g_freeBytes -= size_;
+      g_free[best] = std::move(g_free.back()); g_free.pop_back();
+      return;
+    }
+  }
+  block_.reset(new std::byte[bytes ? bytes : 1]);
+  size_ = bytes;
+}
+
+// Kept only while the pool stays under kMaxPooledBytes, evicting the largest
+// blocks first, and only if it is not far larger than recent requests.
+ScratchLease::~ScratchLease() {
+  std::vector<Block> drop;
+  std::lock_guard<std::mutex> lk(g_mtx);
+  if (size_ > kMaxPooledBytes || size_ > kOversize*g_recent) { drop.push_back({std::move(block_), size_}); return; }
+  while (g_freeBytes + size_ > kMaxPooledBytes) {
+    auto big = std::max_element(g_free.begin(), g_free.end(),
+                                [](const Block& x, const Block& y) { return x.size < y.size; });
+    g_freeBytes -= big->size;
+    drop.push_back(std::move(*big));
+    *big = std::move(g_free.back()); g_free.pop_back();
+  }
+  g_freeBytes += size_;
+  g_free.push_back({std::move(block_), size_});
+}
+
+void scratch_pool_trim() {
+  std::vector<Block> drop;
+  std::lock_guard<std::mutex> lk(g_mtx);
+  drop.swap(g_free);
+  g_freeBytes = 0;
+}
+
+std::size_t scratch_pool_bytes() {
+  std::lock_guard<std::mutex> lk(g_mtx);
+  return g_freeBytes;
+}
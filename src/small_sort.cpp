@@ -0,0 +1,130 @@
+#include "small_sort.hpp"
+#include "elem.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+template<class T, class M>
+static inline bool less_cmp(const T& a, const T& b, M& m) { ++m.comparisons; return a < b; }
+
+template<class T, class M>
+static void insertion_guarded(std::span<T> a, M& m) {
+  for (size_t i=1;i<a.size();++i) {
+    T key = a[i];
+    size_t j = i;
+    while (j>0 && less_cmp(key, a[j-1], m)) {
+      a[j] = a[j-1]; ++m.swaps; --j;
+    }
+    a[j] = key;
+  }
+}
+
+// no j>0 test in the inner loop: something <= key always sits to the left.
+// Without a sentinel the first minimum is rotated to the front, which keeps
+// equal elements in order (a swap would carry a[0] past them).
+template<class T, class M>
+static void insertion_unguarded(std::span<T> a, M& m, const T* sentinel) {
+  if (!sentinel) {
+    size_t mi = 0;
+    for (size_t i=1;i<a.size();++i) if (less_cmp(a[i], a[mi], m)) mi = i;
+    if (mi != 0) { std::rotate(a.begin(), a.begin()+mi, a.begin()+mi+1); m.swaps += mi; }
+  }
+  for (size_t i=1;i<a.size();++i) {
+    T key = a[i];
+    T* p = a.data() + i;
+    while (less_cmp(key, p[-1], m)) { *p = p[-1]; ++m.swaps; --p; }
+    *p = key;
+  }
+}
+
+// fewer comparisons; the shift is one memmove
+template<class T, class M>
+static void insertion_binary(std::span<T> a, M& m) {
+  for (size_t i=1;i<a.size();++i) {
+    T key = a[i];
+    if (!less_cmp(key, a[i-1], m)) continue; // already in place
+    size_t lo = 0, hi = i-1;                 // first element > key is in [lo, hi]
+    while (lo < hi) {
+      size_t mid = lo + (hi-lo)/2;
+      if (less_cmp(key, a[mid], m)) hi = mid; else lo = mid+1;
+    }
+    std::move_backward(a.begin()+lo, a.begin()+i, a.begin()+i+1);
+    m.swaps += i-lo;
+    a[lo] = key;
+  }
+}
+
+// Batcher odd-even merge sort networks for power-of-two sizes, built at compile
+// time and fully unrolled so every compare-exchange is a branch-free select.
+// Networks are not stable; mergesort never runs them.
+struct CE { unsigned char i, j; };
+template<size_t N, class F> constexpr void batcher_for_each(F f) {
+  for (size_t p=1;p<N;p<<=1)
+    for (size_t k=p;k>=1;k>>=1)
+      for (size_t j=k%p;j+k<N;j+=2*k)
+        for (size_t i=0;i<std::min(k, N-j-k);++i)
+          if ((i+j)/(2*p) == (i+j+k)/(2*p)) f(i+j, i+j+k);
+}
+template<size_t N> constexpr size_t batcher_size() {
+  size_t c = 0;
+  batcher_for_each<N>([&](size_t, size_t){ ++c; });
+  return c;
+}
+template<size_t N> constexpr std::array<CE, batcher_size<N>()> make_batcher() {
+  std::array<CE, batcher_size<N>()> net{};
+  size_t c = 0;
+  batcher_for_each<N>([&](size_t i, size_t j){ net[c++] = CE{(unsigned char)i, (unsigned char)j}; });
+  return net;
+}
+template<size_t N> inline constexpr auto kBatcher = make_batcher<N>();
+
+// one comparison decides both slots: min/max would each return x on equal
+// keys and drop y (a record's rowid, the sign of a zero)
+template<class T>
+static inline void cmp_exchange(T& x, T& y) {
+  bool s = y < x;
+  T lo = s ? y : x, hi = s ? x : y;
+  x = lo; y = hi;
+}
+template<size_t N, class T, size_t... K>
+static inline void run_network(T* v, std::index_sequence<K...>) {
+  (cmp_exchange(v[kBatcher<N>[K].i], v[kBatcher<N>[K].j]), ...);
+}
+// pads the slice to N with the type's max value so one network per size class
+// suffices. A padded slice holding a key equal to the pad could swap a real
+// element out (records differing only in rowid), so it takes binary insertion.
+template<size_t N, class T, class M>
+static void network_sort(std::span<T> a, M& m) {
+  if (a.size() < N) {
+    const T pad = ElemTraits<T>::max();
+    for (const T& x : a) if (!(x < pad)) { insertion_binary(a, m); return; }
+  }
+  T v[N];
+  std::copy(a.begin(), a.end(), v);
+  std::fill(v + a.size(), v + N, ElemTraits<T>::max());
+  run_network<N>(v, std::make_index_sequence<kBatcher<N>.size()>{});
+  std::copy(v, v + a.size(), a.begin());
+  m.comparisons += kBatcher<N>.size();
+  m.swaps += 2*a.size();
+}
+
+template<class T, class M>
+void small_sort(std::span<T> a, SmallSort kind, M& m, const T* sentinel) {
+  if (a.size() < 2) return;
+  switch (kind) {
+    case SmallSort::Unguarded: insertion_unguarded(a, m, sentinel); break;
+    case SmallSort::Binary:    insertion_binary(a, m); break;
+    case SmallSort::Network:
+      if      (a.size() <= 4)  network_sort<4>(a, m);
+      else if (a.size() <= 8)  network_sort<8>(a, m);
+      else if (a.size() <= 16) network_sort<16>(a, m);
+      else if (a.size() <= kSmallNetworkMax) network_sort<kSmallNetworkMax>(a, m);
+      else insertion_binary(a, m);
+      break;
+    default:                   insertion_guarded(a, m); break;
+  }
+}
+#define SMALL_SORT_INSTANTIATE(T) \
+  template void small_sort<T, Metrics>(std::span<T>, SmallSort, Metrics&, const T*); \
+  template void small_sort<T, NullMetrics>(std::span<T>, SmallSort, NullMetrics&, const T*);
+ALGO_EVO_FOR_EACH_ELEM(SMALL_SORT_INSTANTIATE)
@@ -0,0 +1,137 @@
+#include "sort_auto.hpp"
+#include "quicksort.hpp"
+#include "mergesort.hpp"
+#include "radix.hpp"
+#include "samplesort.hpp"
+#include "learned.hpp"
+#include "common.hpp"
+#include "elem.hpp"
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+// Positions probed per feature; enough to tell the classes apart at any n.
+constexpr size_t kFeatureSamples = 256;
+// Class thresholds on the sampled features.
+constexpr double kPresortedInversions = 0.1;
+constexpr double kRunFraction = 0.75;
+constexpr double kFewUniqueDuplicates = 0.25;
+constexpr uint64_t kFewUniqueRange = 1u << 16;
+
+const AutoTable& default_auto_table() {
+  static const AutoTable t = []{
+    AutoTable t;
+    RadixDNA random;
+    random.digitBits = 11;
+    MSDNA runs;
+    runs.natural = true;
+    QSDNA few;
+    few.countingThreshold = 1 << 16;
+    few.equalLeft = true;
+    for (auto& row : t.bySize) {
+      row[(int)InputClass::Random] = random;
+      row[(int)InputClass::Presorted] = runs;
+      row[(int)InputClass::Reversed] = runs;
+      row[(int)InputClass::FewUnique] = few;
+    }
+    // Radix's histogram passes do not pay off below a few thousand keys.
+    t.bySize[(int)SizeClass::Small][(int)InputClass::Random] = QSDNA{};
+    return t;
+  }();
+  return t;
+}
+
+const char* input_class_name(InputClass c) {
+  switch (c) {
+    case InputClass::Presorted: return "Presorted";
+    case InputClass::Reversed:  return "Reversed";
+    case InputClass::FewUnique: return "FewUnique";
+    default:                    return "Random";
+  }
+}
+
+const char* size_class_name(SizeClass s) {
+  switch (s) {
+    case SizeClass::Medium: return "Medium";
+    case SizeClass::Large:  return "Large";
+    default:                return "Small";
+  }
+}
+
+SizeClass size_class(size_t n) {
+  if (n >= kLargeMin) return SizeClass::Large;
+  if (n >= kMediumMin) return SizeClass::Medium;
+  return SizeClass::Small;
+}
+
+size_t train_n_for(SizeClass s, size_t n) {
+  switch (s) {
+    case SizeClass::Medium: return std::clamp(n, kMediumMin, kLargeMin - 1);
+    case SizeClass::Large:  return std::max(n, kLargeMin);
+    default:                return std::min(n, kMediumMin - 1);
+  }
+}
+
+InputClass classify_input(const InputFeatures& f) {
+  if (f.inversions <= kPresortedInversions && f.ascending >= kRunFraction) return InputClass::Presorted;
+  if (f.inversions >= 1 - kPresortedInversions && f.descending >= kRunFraction) return InputClass::Reversed;
+  if (f.duplicates >= kFewUniqueDuplicates || f.range < kFewUniqueRange) return InputClass::FewUnique;
+  return InputClass::Random;
+}
+
+template<class T>
+InputFeatures estimate_features(std::span<const T> a) {
+  InputFeatures f;
+  const size_t n = f.n = a.size();
+  if (n < 2) { f.ascending = 1; return f; }
+  XRand rng(n * 0x9E3779B97F4A7C15ull);
+  const size_t S = std::min(kFeatureSamples, n - 1);
+  size_t asc = 0, desc = 0, inv = 0;
+  for (size_t s=0; s<S; ++s) {
+    const size_t i = rng.uniform(0, n-2);
+    asc += a[i] < a[i+1];
+    desc += a[i+1] < a[i];
+    size_t x = rng.uniform(0, n-1), y = rng.uniform(0, n-1);
+    if (x > y) std::swap(x, y);
+    inv += a[y] < a[x];
+  }
+  f.ascending = double(asc) / double(S);
+  f.descending = double(desc) / double(S);
+  f.inversions = double(inv) / double(S);
+
+  // Strided, not random: drawing with replacement would report duplicates
+  // on small inputs that have none.
+  const size_t D = std::min(kFeatureSamples, n);
+  std::vector<T> sample(D);
+  for (size_t i=0; i<D; ++i) sample[i] = a[i * n / D];
+  NullMetrics nm;
+  quicksort(std::span<T>(sample), QSDNA{}, nm);
+  size_t dup = 0;
+  for (size_t i=1; i<D; ++i) dup += !(sample[i-1] < sample[i]);
+  f.duplicates = double(dup) / double(D);
+  if constexpr (std::is_integral_v<T>) {
+    f.range = uint64_t(std::make_unsigned_t<T>(sample.back()) - std::make_unsigned_t<T>(sample.front()));
+  } else if constexpr (std::is_same_v<T, Record>) {
+    f.range = sample.back().key - sample.front().key;
+  }
+  return f;
+}
+
+template<class T, class M>
+void sort_auto(std::span<T> a, const AutoTable& table, M& m) {
+  const InputFeatures f = estimate_features(std::span<const T>(a));
+  std::visit([&](const auto& dna) {
+    using D = std::decay_t<decltype(dna)>;
+    if constexpr (std::is_same_v<D, QSDNA>)          quicksort(a, dna, m);
+    else if constexpr (std::is_same_v<D, MSDNA>)     mergesort(a, dna, m);
+    else if constexpr (std::is_same_v<D, RadixDNA>)  radix_sort(a, dna, m);
+    else if constexpr (std::is_same_v<D, SampleDNA>) samplesort(a, dna, m);
+    else                                             learned_sort(a, dna, m);
+  }, table.bySize[(int)size_class(f.n)][(int)classify_input(f)]);
+}
+
+#define AUTO_INSTANTIATE(T) \
+  template InputFeatures estimate_features<T>(std::span<const T>); \
+  template void sort_auto<T, Metrics>(std::span<T>, const AutoTable&, Metrics&); \
+  template void sort_auto<T, NullMetrics>(std::span<T>, const AutoTable&, NullMetrics&);
+ALGO_EVO_FOR_EACH_ELEM(AUTO_INSTANTIATE)
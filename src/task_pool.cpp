@@ -0,0 +1,66 @@
+#include "task_pool.hpp"
+#include <algorithm>
+
+static thread_local TaskPool* tl_pool = nullptr;
+static thread_local unsigned tl_index = 0;
+
+TaskPool::TaskPool(unsigned workers) {
+  unsigned nq = workers ? workers : 1; // a 0-worker pool still queues for run_one()
+  for (unsigned i=0;i<nq;++i) queues_.push_back(std::make_unique<Queue>());
+  for (unsigned i=0;i<workers;++i) threads_.emplace_back([this, i]{ worker_loop(i); });
+}
+
+TaskPool::~TaskPool() {
+  { std::lock_guard<std::mutex> lk(sleep_mtx_); stop_ = true; }
+  cv_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+void TaskPool::submit(std::function<void()> task) {
+  unsigned idx = (tl_pool == this) ? tl_index : rr_.fetch_add(1, std::memory_order_relaxed) % unsigned(queues_.size());
+  {
+    std::lock_guard<std::mutex> lk(queues_[idx]->mtx);
+    queues_[idx]->q.push_back(std::move(task));
+  }
+  queued_.fetch_add(1, std::memory_order_release);
+  { std::lock_guard<std::mutex> lk(sleep_mtx_); } // pairs with the predicate check in worker_loop
+  cv_.notify_one();
+}
+
+bool TaskPool::pop_or_steal(unsigned home, std::function<void()>& out) {
+  const unsigned n = unsigned(queues_.size());
+  {
+    Queue& own = *queues_[home];
+    std::lock_guard<std::mutex> lk(own.mtx);
+    if (!own.q.empty()) { out = std::move(own.q.back()); own.q.pop_back(); queued_.fetch_sub(1); return true; }
+  }
+  for (unsigned k=1;k<n;++k) {
+    Queue& victim = *queues_[(home + k) % n];
+    std::lock_guard<std::mutex> lk(victim.mtx);
+    if (!victim.q.empty()) { out = std::move(victim.q.front()); victim.q.pop_front(); queued_.fetch_sub(1); return true; }
+  }
+  return false;
+}
+
+bool TaskPool::run_one() {
+  if (queued_.load(std::memory_order_acquire) == 0) return false;
+  std::function<void()> task;
+  if (!pop_or_steal(tl_pool == this ? tl_index : 0, task)) return false;
+  task();
+  return true;
+}
+
+void TaskPool::worker_loop(unsigned idx) {
+  tl_pool = this; tl_index = idx;
+  std::function<void()> task;
+  while (!stop_) {
+    if (pop_or_steal(idx, task)) { task(); task = nullptr; continue; }
+    std::unique_lock<std::mutex> lk(sleep_mtx_);
+    cv_.wait(lk, [&]{ return stop_ || queued_.load() > 0; });
+  }
+}
+
+TaskPool& shared_task_pool() {
+  static TaskPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+  return pool;
+}
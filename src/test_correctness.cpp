@@ -1,17 +1,38 @@
 #include "quicksort.hpp"
 #include "mergesort.hpp"
+#include "radix.hpp"
+#include "samplesort.hpp"
+#include "learned.hpp"
+#include "sort_auto.hpp"
 #include "datasets.hpp"
+#include "evaluator.hpp"
 #include "metrics.hpp"
 #include "dna.hpp"
 #include "common.hpp"
+#include "partition_simd.hpp"
+#include "scratch.hpp"
 #include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <vector>
 #include <span>
+#include <limits>
+#include <type_traits>
 
 using namespace std;
 
+// a holds exactly the elements of ref, records told apart by their rowid
+template<class T>
+static bool same_elements(vector<T> a, vector<T> ref) {
+    auto total = [](const T& x, const T& y) {
+        if constexpr (std::is_same_v<T, Record>) return x.key < y.key || (x.key == y.key && x.rowid < y.rowid);
+        else return x < y;
+    };
+    std::sort(a.begin(), a.end(), total);
+    std::sort(ref.begin(), ref.end(), total);
+    return a == ref;
+}
+
 // simple test helper
 static void test_sort(const string& name, vector<int> arr, bool is_quicksort) {
     Metrics m;
@@ -72,12 +93,12 @@ int main() {
     
     // test 2: duplicates
     {
-        vector<int> dups = make_array(50, Dist::ManyDup, 999);
+        vector<int> dups = make_array(50, Dist::Duplicates, 999);
         test_sort("QuickSort: many duplicates (n=50)", dups, true);
     }
     
     {
-        vector<int> dups = make_array(50, Dist::ManyDup, 999);
+        vector<int> dups = make_array(50, Dist::Duplicates, 999);
         test_sort("MergeSort: many duplicates (n=50)", dups, false);
     }
     
@@ -148,6 +169,600 @@ int main() {
         cout << "✓ QuickSort: Last pivot + Hoare passed\n";
     }
     
+    {
+        vector<int> arr = make_array(5000, Dist::Uniform, 77);
+        Metrics m;
+        QSDNA dna;
+        dna.scheme = PartitionScheme::Block;
+        quicksort(span<int>(arr.data(), arr.size()), dna, m);
+        assert(std::is_sorted(arr.begin(), arr.end()));
+        cout << "✓ QuickSort: Block partition passed\n";
+    }
+    
+    for (int pc = 2; pc <= 3; ++pc) {
+        for (Dist d : {Dist::Uniform, Dist::Duplicates, Dist::Reverse}) {
+            vector<int> arr = make_array(3000, d, 31);
+            Metrics m;
+            QSDNA dna;
+            dna.pivotCount = pc;
+            quicksort(span<int>(arr.data(), arr.size()), dna, m);
+            assert(std::is_sorted(arr.begin(), arr.end()));
+        }
+        cout << "✓ QuickSort: " << pc << "-pivot partition passed\n";
+    }
+    
+    for (DepthFallback f : {DepthFallback::InsertionSort, DepthFallback::HeapSort, DepthFallback::MergeSort}) {
+        vector<int> arr = make_array(2000, Dist::Reverse, 0);
+        Metrics m;
+        QSDNA dna;
+        dna.pivot = Pivot::First;
+        dna.scheme = PartitionScheme::Lomuto;
+        dna.depthCap = 4;  // force the fallback on most of the array
+        dna.depthFallback = f;
+        quicksort(span<int>(arr.data(), arr.size()), dna, m);
+        assert(std::is_sorted(arr.begin(), arr.end()));
+    }
+    cout << "✓ QuickSort: depth cap fallbacks passed\n";
+    
+    for (bool eqLeft : {false, true}) {
+        for (PartitionScheme s : {PartitionScheme::ThreeWay, PartitionScheme::Hoare}) {
+            vector<int> arr = make_array(5000, Dist::Duplicates, 5);
+            Metrics m;
+            QSDNA dna;
+            dna.scheme = s;
+            dna.equalLeft = eqLeft;
+            quicksort(span<int>(arr.data(), arr.size()), dna, m);
+            assert(std::is_sorted(arr.begin(), arr.end()));
+        }
+    }
+    cout << "✓ QuickSort: ThreeWay / equal-left on duplicates passed\n";
+    
+    for (Dist d : {Dist::NearlySorted, Dist::Reverse, Dist::Uniform}) {
+        vector<int> arr = make_array(5000, d, 9);
+        Metrics m;
+        QSDNA dna;
+        dna.presortCheck = true;
+        dna.patternShuffle = true;
+        quicksort(span<int>(arr.data(), arr.size()), dna, m);
+        assert(std::is_sorted(arr.begin(), arr.end()));
+    }
+    cout << "✓ QuickSort: presort check / pattern shuffle passed\n";
+    
+    for (Dist d : {Dist::Uniform, Dist::Duplicates, Dist::Reverse}) {
+        for (size_t n : {size_t(40), size_t(1001), size_t(20000)}) {
+            vector<int> arr = make_array(n, d, 3);
+            Metrics m;
+            QSDNA dna;
+            dna.scheme = PartitionScheme::Simd;
+            dna.equalLeft = true;
+            quicksort(span<int>(arr.data(), arr.size()), dna, m);
+            assert(std::is_sorted(arr.begin(), arr.end()));
+        }
+    }
+    cout << "✓ QuickSort: Simd partition (" << simd_level_name(simd_level()) << ") passed\n";
+    
+    for (Pivot p : {Pivot::Median3, Pivot::Ninther, Pivot::Median5, Pivot::Sampled}) {
+        for (Dist d : {Dist::Uniform, Dist::NearlySorted, Dist::Duplicates}) {
+            vector<int> arr = make_array(4000, d, 21);
+            Metrics m;
+            QSDNA dna;
+            dna.pivot = p;
+            quicksort(span<int>(arr.data(), arr.size()), dna, m);
+            assert(std::is_sorted(arr.begin(), arr.end()));
+        }
+    }
+    cout << "✓ QuickSort: Ninther / Median5 / Sampled pivots passed\n";
+
+    // test every small-sort kernel, as the quicksort base case and the mergesort pre-pass
+    for (SmallSort k : {SmallSort::Insertion, SmallSort::Unguarded, SmallSort::Binary, SmallSort::Network}) {
+        for (int n : {0, 1, 2, 3, 5, 17, 31, 32, 33, 64, 5000}) {
+            vector<int> arr = make_array(std::max(n, 1), Dist::Duplicates, 25 + n);
+            arr.resize(n);
+            vector<int> ref = arr;
+            std::sort(ref.begin(), ref.end());
+            Metrics m;
+            QSDNA dna;
+            dna.smallSortKind = k;
+            dna.insertionCutoff = 64;
+            quicksort(span<int>(arr.data(), arr.size()), dna, m);
+            assert(arr == ref);
+
+            vector<int> arr2 = make_array(std::max(n, 1), Dist::Uniform, 27 + n);
+            arr2.resize(n);
+            vector<int> ref2 = arr2;
+            std::sort(ref2.begin(), ref2.end());
+            MSDNA msdna;
+            msdna.smallSortKind = k;
+            msdna.runThreshold = 48;
+            for (bool it : {true, false}) {
+                vector<int> b = arr2;
+                msdna.iterative = it;
+                mergesort(span<int>(b.data(), b.size()), msdna, m);
+                assert(b == ref2);
+            }
+        }
+        // records with equal keys: quicksort keeps every rowid, mergesort also keeps their order
+        for (int n : {17, 33, 64, 5000}) {
+            vector<Record> rec = make_array<Record>(n, Dist::Duplicates, 35 + n);
+            Metrics m;
+            QSDNA dna;
+            dna.smallSortKind = k;
+            dna.insertionCutoff = 64;
+            vector<Record> q = rec;
+            quicksort(span<Record>(q.data(), q.size()), dna, m);
+            assert(std::is_sorted(q.begin(), q.end()) && same_elements(q, rec));
+            MSDNA msdna;
+            msdna.smallSortKind = k;
+            msdna.runThreshold = 48;
+            for (int mode = 0; mode < 3; ++mode) {
+                vector<Record> b = rec;
+                msdna.iterative = mode == 0;
+                msdna.inPlace = mode == 2;
+                mergesort(span<Record>(b.data(), b.size()), msdna, m);
+                for (size_t i = 1; i < b.size(); ++i)
+                    assert(b[i-1].key < b[i].key || (b[i-1].key == b[i].key && b[i-1].rowid < b[i].rowid));
+            }
+        }
+    }
+    cout << "✓ Small-sort kernels passed\n";
+
+    // test the uninstrumented (NullMetrics) builds of both sorts
+    {
+        vector<int> arr = make_array(20000, Dist::Uniform, 29);
+        vector<int> arr2 = arr;
+        NullMetrics nm;
+        quicksort(span<int>(arr.data(), arr.size()), QSDNA{}, nm);
+        mergesort(span<int>(arr2.data(), arr2.size()), MSDNA{}, nm);
+        assert(std::is_sorted(arr.begin(), arr.end()));
+        assert(arr == arr2);
+        cout << "✓ NullMetrics sorts passed\n";
+    }
+
+    // every entry of the NullMetrics kernel tables (discrete genes as constants)
+    {
+        for (Dist d : {Dist::Uniform, Dist::Duplicates}) {
+            vector<double> base = make_array<double>(3000, d, 37);
+            vector<double> ref = base;
+            std::sort(ref.begin(), ref.end());
+            NullMetrics nm;
+            for (int p = 0; p <= (int)Pivot::Sampled; ++p)
+                for (int s = 0; s <= (int)PartitionScheme::Simd; ++s)
+                    for (bool tail : {false, true}) {
+                        QSDNA dna; dna.pivot = (Pivot)p; dna.scheme = (PartitionScheme)s; dna.tailRecElim = tail;
+                        vector<double> arr = base;
+                        quicksort(span<double>(arr.data(), arr.size()), dna, nm);
+                        assert(arr == ref);
+                    }
+            for (int k = 0; k <= (int)MergeKernel::Simd; ++k)
+                for (bool iter : {false, true})
+                    for (bool reuse : {false, true}) {
+                        MSDNA dna; dna.mergeKernel = (MergeKernel)k; dna.iterative = iter; dna.reuseBuffer = reuse;
+                        vector<double> arr = base;
+                        mergesort(span<double>(arr.data(), arr.size()), dna, nm);
+                        assert(arr == ref);
+                    }
+        }
+        cout << "✓ Kernel tables passed\n";
+    }
+
+    // test the other element types, including the parallel and SIMD-scheme fallbacks
+    auto check_elem = [](auto tag, const char* name) {
+        using T = decltype(tag);
+        for (Dist d : {Dist::Uniform, Dist::NearlySorted, Dist::Reverse, Dist::Duplicates}) {
+            vector<T> arr = make_array<T>(50000, d, 31);
+            vector<T> arr2 = arr;
+            const vector<T> input = arr;
+            Metrics m;
+            QSDNA dna;
+            dna.scheme = PartitionScheme::Simd;
+            dna.smallSortKind = SmallSort::Network;
+            dna.threads = 2;
+            dna.parallelGrain = 1024;
+            quicksort(span<T>(arr.data(), arr.size()), dna, m);
+            assert(std::is_sorted(arr.begin(), arr.end()) && same_elements(arr, input));
+            mergesort(span<T>(arr2.data(), arr2.size()), MSDNA{}, m);
+            vector<T> ref = input;
+            std::stable_sort(ref.begin(), ref.end());
+            assert(arr2 == ref);
+        }
+        cout << "✓ Element type " << name << " passed\n";
+    };
+    check_elem(int64_t{}, "i64");
+    check_elem(float{}, "f32");
+    check_elem(double{}, "f64");
+    check_elem(Record{}, "record");
+
+    // test recursive mergesort buffer strategies (arena vs per-level, pooled or not)
+    for (MergeBuffer b : {MergeBuffer::PerLevel, MergeBuffer::Arena}) {
+        for (bool reuse : {false, true}) {
+            vector<int> arr = make_array(30001, Dist::Uniform, 33);
+            Metrics m;
+            MSDNA dna;
+            dna.iterative = false;
+            dna.buffer = b;
+            dna.reuseBuffer = reuse;
+            mergesort(span<int>(arr.data(), arr.size()), dna, m);
+            assert(std::is_sorted(arr.begin(), arr.end()));
+        }
+    }
+    cout << "✓ MergeSort: buffer strategies passed\n";
+
+    // the scratch pool stays bounded: oversized and stale blocks are not kept
+    {
+        scratch_pool_trim();
+        { ScratchLease big(size_t(100) << 20); }
+        assert(scratch_pool_bytes() == 0);           // above the 64 MiB cap
+        { ScratchLease a(1 << 20); }
+        assert(scratch_pool_bytes() == size_t(1) << 20);
+        for (int i = 0; i < 200; ++i) { ScratchLease s(1 << 10); }
+        assert(scratch_pool_bytes() <= size_t(4) << 10); // the 1 MiB block went stale
+        scratch_pool_trim();
+        assert(scratch_pool_bytes() == 0);
+        cout << "✓ Scratch pool bounds passed\n";
+    }
+
+    // test parallel mergesort (merge-path merges) is sorted and stable
+    for (bool it : {true, false}) {
+        vector<Record> arr = make_array<Record>(100003, Dist::Duplicates, 35);
+        Metrics m;
+        MSDNA dna;
+        dna.iterative = it;
+        dna.threads = 4;
+        dna.parallelGrain = 1000;
+        mergesort(span<Record>(arr.data(), arr.size()), dna, m);
+        for (size_t i=1;i<arr.size();++i) {
+            assert(!(arr[i] < arr[i-1]));
+            assert(arr[i-1].key != arr[i].key || arr[i-1].rowid < arr[i].rowid);
+        }
+    }
+    cout << "✓ MergeSort: parallel merge-path passed\n";
+
+    // test merge kernels: the SIMD kernel only runs for int without counting,
+    // every kernel must stay stable on Record
+    for (MergeKernel k : {MergeKernel::Branchy, MergeKernel::Branchless, MergeKernel::Simd}) {
+        for (bool it : {true, false}) {
+            for (size_t n : {size_t(7), size_t(17), size_t(1000), size_t(30011)}) {
+                for (Dist d : {Dist::Uniform, Dist::Duplicates, Dist::NearlySorted}) {
+                    vector<int> arr = make_array(n, d, 37);
+                    vector<int> ref = arr;
+                    std::sort(ref.begin(), ref.end());
+                    MSDNA dna;
+                    dna.iterative = it;
+                    dna.mergeKernel = k;
+                    NullMetrics nm;
+                    mergesort(span<int>(arr.data(), arr.size()), dna, nm);
+                    assert(arr == ref);
+                }
+            }
+            vector<Record> rec = make_array<Record>(20011, Dist::Duplicates, 38);
+            MSDNA dna;
+            dna.iterative = it;
+            dna.mergeKernel = k;
+            Metrics m;
+            mergesort(span<Record>(rec.data(), rec.size()), dna, m);
+            for (size_t i=1;i<rec.size();++i)
+                assert(rec[i-1].key < rec[i].key || (rec[i-1].key == rec[i].key && rec[i-1].rowid < rec[i].rowid));
+        }
+        vector<int> arr = make_array(100003, Dist::Uniform, 39);
+        MSDNA dna;
+        dna.mergeKernel = k;
+        dna.threads = 4;
+        dna.parallelGrain = 1000;
+        NullMetrics nm;
+        mergesort(span<int>(arr.data(), arr.size()), dna, nm);
+        assert(std::is_sorted(arr.begin(), arr.end()));
+    }
+    cout << "✓ MergeSort: merge kernels passed\n";
+
+    // test natural mode (run detection + Powersort + galloping): sorted and
+    // stable for every distribution, near-linear on presorted input
+    for (int minGallop : {1, 7, 64}) {
+        for (int minRun : {8, 64}) {
+            for (Dist d : {Dist::Uniform, Dist::NearlySorted, Dist::Reverse, Dist::Duplicates}) {
+                vector<Record> rec = make_array<Record>(20011, d, 41);
+                MSDNA dna;
+                dna.natural = true;
+                dna.minRun = minRun;
+                dna.minGallop = minGallop;
+                Metrics m;
+                mergesort(span<Record>(rec.data(), rec.size()), dna, m);
+                for (size_t i=1;i<rec.size();++i)
+                    assert(rec[i-1].key < rec[i].key || (rec[i-1].key == rec[i].key && rec[i-1].rowid < rec[i].rowid));
+            }
+        }
+    }
+    {
+        // append-mostly: a sorted log with a short unsorted tail
+        vector<int> arr(100000);
+        for (size_t i=0;i<arr.size();++i) arr[i] = (int)i;
+        vector<int> tail = make_array(500, Dist::Uniform, 43);
+        for (size_t i=0;i<tail.size();++i) arr[arr.size()-tail.size()+i] = tail[i] % 100000;
+        MSDNA dna;
+        dna.natural = true;
+        Metrics m;
+        mergesort(span<int>(arr.data(), arr.size()), dna, m);
+        assert(std::is_sorted(arr.begin(), arr.end()));
+        assert(m.comparisons < 2*arr.size());
+        vector<int> rev(100000);
+        for (size_t i=0;i<rev.size();++i) rev[i] = (int)(rev.size()-i);
+        Metrics mr;
+        mergesort(span<int>(rev.data(), rev.size()), dna, mr);
+        assert(std::is_sorted(rev.begin(), rev.end()));
+        assert(mr.comparisons < rev.size());
+    }
+    cout << "✓ MergeSort: natural runs + galloping passed\n";
+
+    // test k-way bottom-up merging (loser tree): sorted and stable, including
+    // sizes that leave partial groups and empty runs in the last group
+    for (int arity : {2, 4, 8, 16}) {
+        for (int run : {0, 1, 16}) {
+            for (size_t n : {size_t(2), size_t(33), size_t(1000), size_t(40009)}) {
+                vector<Record> rec = make_array<Record>(n, Dist::Duplicates, 45);
+                MSDNA dna;
+                dna.mergeArity = arity;
+                dna.runThreshold = run;
+                Metrics m;
+                mergesort(span<Record>(rec.data(), rec.size()), dna, m);
+                for (size_t i=1;i<rec.size();++i)
+                    assert(rec[i-1].key < rec[i].key || (rec[i-1].key == rec[i].key && rec[i-1].rowid < rec[i].rowid));
+            }
+        }
+    }
+    cout << "✓ MergeSort: k-way loser-tree merges passed\n";
+
+    // test in-place mode: sorted, stable, and its scratch stays within the
+    // fixed buffer while the buffered modes report their n-sized one
+    for (int buf : {0, 1, 64, 4096}) {
+        for (Dist d : {Dist::Uniform, Dist::NearlySorted, Dist::Reverse, Dist::Duplicates}) {
+            vector<Record> rec = make_array<Record>(20011, d, 47);
+            MSDNA dna;
+            dna.inPlace = true;
+            dna.inPlaceBuffer = buf;
+            dna.threads = 4;
+            Metrics m;
+            mergesort(span<Record>(rec.data(), rec.size()), dna, m);
+            for (size_t i=1;i<rec.size();++i)
+                assert(rec[i-1].key < rec[i].key || (rec[i-1].key == rec[i].key && rec[i-1].rowid < rec[i].rowid));
+            assert(m.auxBytes <= size_t(buf)*sizeof(Record));
+        }
+    }
+    {
+        vector<int> arr = make_array(10000, Dist::Uniform, 49);
+        NullMetrics nm;
+        mergesort(span<int>(arr.data(), arr.size()), MSDNA{}, nm);
+        assert(nm.auxBytes == arr.size()*sizeof(int));
+    }
+    cout << "✓ MergeSort: in-place mode passed\n";
+
+    // test radix sort: every order/layout/digit width on every element type,
+    // plus negative and mixed-sign keys; the buffered variants must be stable
+    auto check_radix = [](auto tag, const char* name) {
+        using T = decltype(tag);
+        for (RadixOrder o : {RadixOrder::LSD, RadixOrder::MSD}) {
+            for (bool inPlace : {false, true}) {
+                for (int bits : {4, 8, 11, 16}) {
+                    for (int fb : {0, 64}) {
+                        for (Dist d : {Dist::Uniform, Dist::Reverse, Dist::Duplicates}) {
+                            vector<T> arr = make_array<T>(20011, d, 51);
+                            RadixDNA dna;
+                            dna.order = o;
+                            dna.inPlace = inPlace;
+                            dna.digitBits = bits;
+                            dna.fallbackThreshold = fb;
+                            dna.prefetch = bits == 8;
+                            Metrics m;
+                            radix_sort(span<T>(arr.data(), arr.size()), dna, m);
+                            assert(std::is_sorted(arr.begin(), arr.end()));
+                            if constexpr (std::is_same_v<T, Record>) {
+                                if (o == RadixOrder::LSD || !inPlace)
+                                    for (size_t i=1;i<arr.size();++i)
+                                        assert(arr[i-1].key != arr[i].key || arr[i-1].rowid < arr[i].rowid);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        cout << "✓ RadixSort: element type " << name << " passed\n";
+    };
+    check_radix(int{}, "i32");
+    check_radix(int64_t{}, "i64");
+    check_radix(float{}, "f32");
+    check_radix(double{}, "f64");
+    check_radix(Record{}, "record");
+    {
+        vector<int> ints = {5, -3, 0, -2147483647-1, 2147483647, -1, 7, -3, 1};
+        vector<double> dbls = {1.5, -0.25, 0.0, -1e300, 1e300, -7.0, 3.0, -0.0, 2.5};
+        for (RadixOrder o : {RadixOrder::LSD, RadixOrder::MSD}) {
+            for (bool inPlace : {false, true}) {
+                RadixDNA dna;
+                dna.order = o;
+                dna.inPlace = inPlace;
+                dna.fallbackThreshold = 0;
+                vector<int> a = ints;
+                vector<double> b = dbls;
+                NullMetrics nm;
+                radix_sort(span<int>(a.data(), a.size()), dna, nm);
+                radix_sort(span<double>(b.data(), b.size()), dna, nm);
+                assert(std::is_sorted(a.begin(), a.end()));
+                assert(std::is_sorted(b.begin(), b.end()));
+            }
+        }
+        cout << "✓ RadixSort: signed keys passed\n";
+    }
+    auto check_sample = [](auto tag, const char* name) {
+        using T = decltype(tag);
+        for (SampleBase b : {SampleBase::QuickSort, SampleBase::MergeSort, SampleBase::Radix}) {
+            for (int buckets : {4, 64, 256}) {
+                for (int threads : {1, 4}) {
+                    for (Dist d : {Dist::Uniform, Dist::NearlySorted, Dist::Reverse, Dist::Duplicates}) {
+                        vector<T> arr = make_array<T>(50021, d, 61);
+                        SampleDNA dna;
+                        dna.baseCase = b;
+                        dna.buckets = buckets;
+                        dna.oversample = buckets == 4 ? 1 : 8;
+                        dna.baseThreshold = 256;
+                        dna.threads = threads;
+                        dna.parallelGrain = 4096;
+                        Metrics m;
+                        samplesort(span<T>(arr.data(), arr.size()), dna, m);
+                        assert(std::is_sorted(arr.begin(), arr.end()));
+                        assert(m.auxBytes >= arr.size() * sizeof(T));
+                    }
+                }
+            }
+        }
+        vector<T> same(30000, T{});
+        SampleDNA dna;
+        dna.baseThreshold = 256;
+        Metrics m;
+        samplesort(span<T>(same.data(), same.size()), dna, m);
+        cout << "✓ SampleSort: element type " << name << " passed\n";
+    };
+    check_sample(int{}, "i32");
+    check_sample(int64_t{}, "i64");
+    check_sample(float{}, "f32");
+    check_sample(double{}, "f64");
+    check_sample(Record{}, "record");
+    auto check_learned = [](auto tag, const char* name) {
+        using T = decltype(tag);
+        for (int perm : {1, 10, 100}) {
+            for (int segs : {16, 4096}) {
+                for (int fan : {16, 1024, 4096}) {
+                    for (Dist d : {Dist::Uniform, Dist::NearlySorted, Dist::Reverse, Dist::Duplicates}) {
+                        vector<T> arr = make_array<T>(30011, d, 71);
+                        LearnedDNA dna;
+                        dna.samplePermille = perm;
+                        dna.segments = segs;
+                        dna.fanout = fan;
+                        Metrics m;
+                        learned_sort(span<T>(arr.data(), arr.size()), dna, m);
+                        assert(std::is_sorted(arr.begin(), arr.end()));
+                    }
+                }
+            }
+        }
+        cout << "✓ LearnedSort: element type " << name << " passed\n";
+    };
+    check_learned(int{}, "i32");
+    check_learned(int64_t{}, "i64");
+    check_learned(float{}, "f32");
+    check_learned(double{}, "f64");
+    check_learned(Record{}, "record");
+    {
+        // Skewed keys (most mass in one model segment), extreme values and a
+        // constant array: the model is poor, the fix-up must still sort.
+        vector<int64_t> skew(50000);
+        XRand rng(5);
+        for (auto& x : skew) x = int64_t(1) << rng.uniform(0, 62);
+        skew[7] = std::numeric_limits<int64_t>::min();
+        skew[9] = std::numeric_limits<int64_t>::max();
+        vector<double> same(20000, 3.5);
+        LearnedDNA dna;
+        Metrics m;
+        learned_sort(span<int64_t>(skew.data(), skew.size()), dna, m);
+        learned_sort(span<double>(same.data(), same.size()), dna, m);
+        assert(std::is_sorted(skew.begin(), skew.end()));
+        cout << "✓ LearnedSort: skewed keys passed\n";
+    }
+    auto check_counting = [](auto tag, const char* name) {
+        using T = decltype(tag);
+        constexpr bool integral = !std::is_floating_point_v<T>;
+        for (int thr : {0, 100, 1 << 20}) {
+            for (Dist d : {Dist::Uniform, Dist::Duplicates}) {
+                vector<T> base = make_array<T>(40009, d, 81);
+                const bool takes = integral && thr > 100 && d == Dist::Duplicates;
+                QSDNA q;
+                q.countingThreshold = thr;
+                vector<T> a1 = base;
+                Metrics m1;
+                quicksort(span<T>(a1.data(), a1.size()), q, m1);
+                assert(std::is_sorted(a1.begin(), a1.end()));
+                if (takes) assert(m1.comparisons <= 2 * a1.size() + 128);
+                MSDNA s;
+                s.countingThreshold = thr;
+                s.threads = 2;
+                s.parallelGrain = 4096;
+                vector<T> a2 = base;
+                Metrics m2;
+                mergesort(span<T>(a2.data(), a2.size()), s, m2);
+                assert(std::is_sorted(a2.begin(), a2.end()));
+                if (takes) assert(m2.comparisons <= 2 * a2.size() + 128);
+                if constexpr (std::is_same_v<T, Record>) {
+                    for (size_t i=1;i<a2.size();++i)
+                        assert(a2[i-1].key != a2[i].key || a2[i-1].rowid < a2[i].rowid);
+                }
+            }
+        }
+        cout << "✓ Counting fast path: element type " << name << " passed\n";
+    };
+    check_counting(int{}, "i32");
+    check_counting(int64_t{}, "i64");
+    check_counting(float{}, "f32");
+    check_counting(Record{}, "record");
+    {
+        // Keys at both ends of the type: the range is computed unsigned.
+        vector<int> a(5000);
+        for (size_t i=0;i<a.size();++i) a[i] = int(i % 7) - 3 + (i % 2 ? std::numeric_limits<int>::min() + 3 : 0);
+        vector<int64_t> b(5000);
+        for (size_t i=0;i<b.size();++i) b[i] = std::numeric_limits<int64_t>::max() - int64_t(i % 50);
+        QSDNA q;
+        q.countingThreshold = 1 << 20;
+        Metrics m;
+        quicksort(span<int>(a.data(), a.size()), q, m);
+        quicksort(span<int64_t>(b.data(), b.size()), q, m);
+        assert(std::is_sorted(a.begin(), a.end()));
+        assert(std::is_sorted(b.begin(), b.end()));
+        cout << "✓ Counting fast path: extreme keys passed\n";
+    }
+    auto check_auto = [](auto tag, const char* name) {
+        using T = decltype(tag);
+        // Every family in some slot of every size, plus the defaults.
+        const AutoChoice families[] = {LearnedDNA{}, SampleDNA{}, QSDNA{}, RadixDNA{}, MSDNA{}};
+        AutoTable mixed;
+        for (int s = 0; s < kSizeClasses; ++s)
+            for (int c = 0; c < kInputClasses; ++c) mixed.bySize[s][c] = families[(s + c) % 5];
+        for (Dist d : {Dist::Uniform, Dist::NearlySorted, Dist::Reverse, Dist::Duplicates}) {
+            for (size_t n : {size_t(0), size_t(1), size_t(100), size_t(20000), kLargeMin}) {
+                vector<T> base = n > 1 ? make_array<T>(n, d, 91) : vector<T>(n);
+                if (n >= 100) assert(dist_for_class(classify_input(estimate_features(span<const T>(base.data(), base.size())))) == d);
+                for (const AutoTable* t : {&default_auto_table(), (const AutoTable*)&mixed}) {
+                    vector<T> arr = base;
+                    Metrics m;
+                    sort_auto(span<T>(arr.data(), arr.size()), *t, m);
+                    assert(std::is_sorted(arr.begin(), arr.end()));
+                }
+            }
+        }
+        cout << "✓ sort_auto: element type " << name << " passed\n";
+    };
+    for (int s = 0; s < kSizeClasses; ++s)
+        for (size_t n : {size_t(1000), size_t(50000), size_t(1) << 20})
+            assert(size_class(train_n_for((SizeClass)s, n)) == (SizeClass)s);
+    assert(size_class(kMediumMin - 1) == SizeClass::Small && size_class(kMediumMin) == SizeClass::Medium);
+    assert(size_class(kLargeMin - 1) == SizeClass::Medium && size_class(kLargeMin) == SizeClass::Large);
+    check_auto(int{}, "i32");
+    check_auto(int64_t{}, "i64");
+    check_auto(float{}, "f32");
+    check_auto(double{}, "f64");
+    check_auto(Record{}, "record");
+
+    // test parallel quicksort on the work-stealing pool
+    for (PartitionScheme s : {PartitionScheme::Hoare, PartitionScheme::Simd}) {
+        for (Dist d : {Dist::Uniform, Dist::Reverse, Dist::Duplicates}) {
+            vector<int> arr = make_array(200000, d, 23);
+            Metrics m;
+            QSDNA dna;
+            dna.scheme = s;
+            dna.threads = 4;
+            dna.parallelGrain = 256;
+            quicksort(span<int>(arr.data(), arr.size()), dna, m);
+            assert(std::is_sorted(arr.begin(), arr.end()));
+            assert(m.comparisons > 0);
+        }
+    }
+    cout << "✓ QuickSort: parallel work-stealing passed\n";
+    
     // test mergesort variants
     {
         vector<int> arr = make_array(100, Dist::Uniform, 456);
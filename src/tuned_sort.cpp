@@ -0,0 +1,35 @@
+#include "tuned_sort.hpp"
+#include "tuned_dna.hpp"
+#include "quicksort.hpp"
+#include "mergesort.hpp"
+#include "sort_auto.hpp"
+#include "elem.hpp"
+
+template<class T>
+void tuned_quicksort(std::span<T> a) {
+  NullMetrics m;
+  quicksort_fixed<kTunedQS>(a, m);
+}
+template<class T>
+void tuned_mergesort(std::span<T> a) {
+  NullMetrics m;
+  mergesort_fixed<kTunedMS>(a, m);
+}
+const AutoTable& tuned_auto_table() {
+#ifdef ALGO_EVO_TUNED_AUTO
+  return kTunedAuto;
+#else
+  return default_auto_table();
+#endif
+}
+template<class T>
+void tuned_sort_auto(std::span<T> a) {
+  NullMetrics m;
+  sort_auto(a, tuned_auto_table(), m);
+}
+
+#define TUNED_INSTANTIATE(T) \
+  template void tuned_quicksort<T>(std::span<T>); \
+  template void tuned_mergesort<T>(std::span<T>); \
+  template void tuned_sort_auto<T>(std::span<T>);
+ALGO_EVO_FOR_EACH_ELEM(TUNED_INSTANTIATE)
@@ -23,6 +23,9 @@
   const spaceStat = document.getElementById('spaceStat');
   const lbQS = document.getElementById('lbQS');
   const lbMS = document.getElementById('lbMS');
+  const lbRadix = document.getElementById('lbRadix');
+  const lbSample = document.getElementById('lbSample');
+  const lbLearned = document.getElementById('lbLearned');
   const lbGA = document.getElementById('lbGA');
   const lbSA = document.getElementById('lbSA');
 
@@ -154,13 +157,24 @@
         const run_threshold = cells[colIndex.run_threshold] || '';
         const iterative = cells[colIndex.iterative] || '';
         const reuse_buffer = cells[colIndex.reuse_buffer] || '';
+        const digit_bits = colIndex.digit_bits != null ? cells[colIndex.digit_bits] : '';
+        const radix_order = colIndex.radix_order != null ? cells[colIndex.radix_order] : '';
+        const radix_in_place = colIndex.radix_in_place != null ? cells[colIndex.radix_in_place] : '';
+        const buckets = colIndex.buckets != null ? cells[colIndex.buckets] : '';
+        const oversample = colIndex.oversample != null ? cells[colIndex.oversample] : '';
+        const base_case = colIndex.base_case != null ? cells[colIndex.base_case] : '';
+        const sample_permille = colIndex.sample_permille != null ? cells[colIndex.sample_permille] : '';
+        const segments = colIndex.segments != null ? cells[colIndex.segments] : '';
+        const fanout = colIndex.fanout != null ? cells[colIndex.fanout] : '';
         const ga_idx = colIndex.ga_population_index != null ? cells[colIndex.ga_population_index] : (colIndex.pop_idx != null ? cells[colIndex.pop_idx] : '');
         const sa_temp = colIndex.sa_temperature != null ? cells[colIndex.sa_temperature] : (colIndex.temp != null ? cells[colIndex.temp] : '');
 
         const p = {
           step, algo, opt, fitness_ms, comparisons, swaps, n,
           dna: {
-            pivot, scheme, cutoff, depth, tail, run_threshold, iterative, reuse_buffer
+            pivot, scheme, cutoff, depth, tail, run_threshold, iterative, reuse_buffer,
+            digit_bits, radix_order, radix_in_place, buckets, oversample, base_case,
+            sample_permille, segments, fanout
           },
           ga_idx, sa_temp
         };
@@ -248,7 +262,7 @@
   }
   function particleColor(p){
     if(colorMode && colorMode.value === 'algorithm'){
-      return p.algo === 'QS' ? '#3fa7ff' : '#ff8e3f';
+      return p.algo === 'QS' ? '#3fa7ff' : p.algo === 'Radix' ? '#b07cff' : p.algo === 'Sample' ? '#3fd6a0' : p.algo === 'Learned' ? '#ff5fa2' : '#ff8e3f';
     }
     const q = fitnessQuantilesByStep.get(p.step);
     if(!q) return '#7bc96f';
@@ -266,6 +280,14 @@
       const worst = (d.pivot === 'First' || d.pivot === 'Last') ? 'worst O(n) if adversarial' : 'balanced pivots typical';
       const tail = d.tail ? ', tail-elim' : '';
       return `${typical}${tail}; ${worst}`;
+    }else if(p.algo === 'Radix'){
+      const d = p.dna || {};
+      const inPlace = d.radix_order === 'MSD' && (d.radix_in_place === '1' || d.radix_in_place === true);
+      return inPlace ? 'O(2^bits) counts per digit level, in place' : 'O(n) buffer + O(2^bits) counts';
+    }else if(p.algo === 'Sample'){
+      return 'O(n) buffer + O(n) bucket oracle';
+    }else if(p.algo === 'Learned'){
+      return 'O(n) buffer + O(n) bucket oracle + O(segments) model';
     }else{
       const d = p.dna || {};
       const buf = 'O(n) buffer';
@@ -283,9 +305,12 @@
     const shouldIncludeSA = (optFilterVal === 'all' || optFilterVal === 'SA');
     const shouldIncludeQS = (algoFilterVal === 'all' || algoFilterVal === 'QS');
     const shouldIncludeMS = (algoFilterVal === 'all' || algoFilterVal === 'MS');
+    const shouldIncludeRadix = (algoFilterVal === 'all' || algoFilterVal === 'Radix');
+    const shouldIncludeSample = (algoFilterVal === 'all' || algoFilterVal === 'Sample');
+    const shouldIncludeLearned = (algoFilterVal === 'all' || algoFilterVal === 'Learned');
     
-    let bestQS = null, bestMS = null, bestGA = null, bestSA = null;
-    let hasGA = false, hasSA = false, hasQS = false, hasMS = false;
+    let bestQS = null, bestMS = null, bestRadix = null, bestSample = null, bestLearned = null, bestGA = null, bestSA = null;
+    let hasGA = false, hasSA = false, hasQS = false, hasMS = false, hasRadix = false, hasSample = false, hasLearned = false;
     
     for(const p of points){
       if(p.step > stepThreshold + 0.5) continue;
@@ -294,6 +319,9 @@
       if(p.opt === 'SA' && !shouldIncludeSA) continue;
       if(p.algo === 'QS' && !shouldIncludeQS) continue;
       if(p.algo === 'MS' && !shouldIncludeMS) continue;
+      if(p.algo === 'Radix' && !shouldIncludeRadix) continue;
+      if(p.algo === 'Sample' && !shouldIncludeSample) continue;
+      if(p.algo === 'Learned' && !shouldIncludeLearned) continue;
       
       if(p.algo === 'QS' && shouldIncludeQS){
         hasQS = true;
@@ -303,6 +331,18 @@
         hasMS = true;
         if(!bestMS || p.fitness_ms < bestMS.fitness_ms) bestMS = p;
       }
+      if(p.algo === 'Radix' && shouldIncludeRadix){
+        hasRadix = true;
+        if(!bestRadix || p.fitness_ms < bestRadix.fitness_ms) bestRadix = p;
+      }
+      if(p.algo === 'Sample' && shouldIncludeSample){
+        hasSample = true;
+        if(!bestSample || p.fitness_ms < bestSample.fitness_ms) bestSample = p;
+      }
+      if(p.algo === 'Learned' && shouldIncludeLearned){
+        hasLearned = true;
+        if(!bestLearned || p.fitness_ms < bestLearned.fitness_ms) bestLearned = p;
+      }
       if(p.opt === 'GA' && shouldIncludeGA){
         hasGA = true;
         if(!bestGA || p.fitness_ms < bestGA.fitness_ms) bestGA = p;
@@ -314,6 +354,9 @@
     }   
     lbQS && (lbQS.textContent = (hasQS && shouldIncludeQS && bestQS) ? `${bestQS.fitness_ms.toFixed(3)} ms` : '—');
     lbMS && (lbMS.textContent = (hasMS && shouldIncludeMS && bestMS) ? `${bestMS.fitness_ms.toFixed(3)} ms` : '—');
+    lbRadix && (lbRadix.textContent = (hasRadix && shouldIncludeRadix && bestRadix) ? `${bestRadix.fitness_ms.toFixed(3)} ms` : '—');
+    lbSample && (lbSample.textContent = (hasSample && shouldIncludeSample && bestSample) ? `${bestSample.fitness_ms.toFixed(3)} ms` : '—');
+    lbLearned && (lbLearned.textContent = (hasLearned && shouldIncludeLearned && bestLearned) ? `${bestLearned.fitness_ms.toFixed(3)} ms` : '—');
     lbGA && (lbGA.textContent = (hasGA && shouldIncludeGA && bestGA) ? `${bestGA.fitness_ms.toFixed(3)} ms` : '—');
     lbSA && (lbSA.textContent = (hasSA && shouldIncludeSA && bestSA) ? `${bestSA.fitness_ms.toFixed(3)} ms` : '—');
   }
@@ -482,6 +525,12 @@
       `Comparisons: ${p.comparisons.toLocaleString()} | Swaps: ${p.swaps.toLocaleString()}`,
       p.algo === 'QS'
         ? `Pivot=${d.pivot}  Scheme=${d.scheme}  Cutoff=${d.cutoff}  Depth=${d.depth}  Tail=${d.tail}`
+        : p.algo === 'Radix'
+        ? `Order=${d.radix_order}  DigitBits=${d.digit_bits}  InPlace=${d.radix_in_place}`
+        : p.algo === 'Sample'
+        ? `Buckets=${d.buckets}  Oversample=${d.oversample}  Base=${d.base_case}`
+        : p.algo === 'Learned'
+        ? `SamplePermille=${d.sample_permille}  Segments=${d.segments}  Fanout=${d.fanout}`
         : `RunThresh=${d.run_threshold}  Iterative=${d.iterative}  ReuseBuf=${d.reuse_buffer}`
     ].join('\n');
   }